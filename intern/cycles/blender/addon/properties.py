@@ -391,6 +391,12 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         min=0.0, max=1.0,
         default=0.01,
     )
+    use_light_tree: BoolProperty(
+        name="Light Tree",
+        description="Pick lights by their estimated contribution to the shading point, rather than by area. "
+        "Faster to converge in scenes with many lights, not used when sampling all lights",
+        default=False,
+    )
 
     use_adaptive_sampling: BoolProperty(
         name="Use Adaptive Sampling",
@@ -681,6 +687,11 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         description="Use special type BVH optimized for hair (uses more ram but renders faster)",
         default=True,
     )
+    debug_use_compressed_bvh: BoolProperty(
+        name="Use Compressed BVH",
+        description="Store BVH node bounds with reduced precision (uses less ram but renders slower)",
+        default=False,
+    )
     debug_bvh_time_steps: IntProperty(
         name="BVH Time Steps",
         description="Split BVH primitives by this number of time steps to speed up render time in cost of memory",
@@ -794,6 +805,37 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         items=enum_texture_limit
     )
 
+    use_texture_cache: BoolProperty(
+        name="Texture Cache",
+        description="Read image textures on demand in tiles and mipmap levels instead of loading "
+        "them fully before rendering, only supported on the CPU",
+        default=False,
+    )
+    texture_cache_size: IntProperty(
+        name="Cache Size",
+        description="Maximum memory used by the texture cache, in megabytes",
+        default=1024,
+        min=1, max=1048576,
+    )
+    texture_cache_tile_size: IntProperty(
+        name="Tile Size",
+        description="Size of tiles read at once from images that are not stored tiled",
+        default=64,
+        min=8, max=4096,
+    )
+    texture_auto_convert: BoolProperty(
+        name="Auto Convert",
+        description="Convert images to tiled and mipmapped .tx files before rendering, "
+        "files are converted again only when the image is newer",
+        default=False,
+    )
+    texture_cache_path: StringProperty(
+        name="Cache Path",
+        description="Directory for converted .tx files, next to the original images when empty",
+        default="",
+        subtype='DIR_PATH',
+    )
+
     ao_bounces: IntProperty(
         name="AO Bounces",
         default=0,
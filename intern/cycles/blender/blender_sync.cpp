@@ -308,6 +308,12 @@ void BlenderSync::sync_integrator()
   integrator->sample_all_lights_indirect = get_boolean(cscene, "sample_all_lights_indirect");
   integrator->light_sampling_threshold = get_float(cscene, "light_sampling_threshold");
 
+  const bool use_light_tree = get_boolean(cscene, "use_light_tree");
+  if (integrator->use_light_tree != use_light_tree) {
+    scene->light_manager->tag_update(scene);
+  }
+  integrator->use_light_tree = use_light_tree;
+
   if (RNA_boolean_get(&cscene, "use_adaptive_sampling")) {
     integrator->sampling_pattern = SAMPLING_PATTERN_PMJ;
     integrator->adaptive_min_samples = get_int(cscene, "adaptive_min_samples");
@@ -721,6 +727,12 @@ void BlenderSync::free_data_after_sync(BL::Depsgraph &b_depsgraph)
   if (!can_free_caches) {
     return;
   }
+  /* With persistent data Blender keeps the depsgraph between frames, its evaluated objects are
+   * reused and only updated when changed, so their caches must stay. */
+  const bool is_depsgraph_kept = b_scene.render().use_persistent_data() && !b_engine.is_preview();
+  if (is_depsgraph_kept) {
+    return;
+  }
   /* TODO(sergey): We can actually remove the whole dependency graph,
    * but that will need some API support first.
    */
@@ -732,7 +744,9 @@ void BlenderSync::free_data_after_sync(BL::Depsgraph &b_depsgraph)
 
 /* Scene Parameters */
 
-SceneParams BlenderSync::get_scene_params(BL::Scene &b_scene, bool background)
+SceneParams BlenderSync::get_scene_params(BL::BlendData &b_data,
+                                          BL::Scene &b_scene,
+                                          bool background)
 {
   BL::RenderSettings r = b_scene.render();
   SceneParams params;
@@ -751,6 +765,7 @@ SceneParams BlenderSync::get_scene_params(BL::Scene &b_scene, bool background)
 
   params.use_bvh_spatial_split = RNA_boolean_get(&cscene, "debug_use_spatial_splits");
   params.use_bvh_unaligned_nodes = RNA_boolean_get(&cscene, "debug_use_hair_bvh");
+  params.use_bvh_quantized_nodes = RNA_boolean_get(&cscene, "debug_use_compressed_bvh");
   params.num_bvh_time_steps = RNA_int_get(&cscene, "debug_bvh_time_steps");
 
   PointerRNA csscene = RNA_pointer_get(&b_scene.ptr, "cycles_curves");
@@ -777,6 +792,13 @@ SceneParams BlenderSync::get_scene_params(BL::Scene &b_scene, bool background)
     params.texture_limit = 0;
   }
 
+  params.texture_cache.use_cache = get_boolean(cscene, "use_texture_cache");
+  params.texture_cache.cache_size = get_int(cscene, "texture_cache_size");
+  params.texture_cache.tile_size = get_int(cscene, "texture_cache_tile_size");
+  params.texture_cache.auto_convert = get_boolean(cscene, "texture_auto_convert");
+  params.texture_cache.cache_path = blender_absolute_path(
+      b_data, b_scene, get_string(cscene, "texture_cache_path"));
+
   params.bvh_layout = DebugFlags().cpu.bvh_layout;
 
   params.background = background;
@@ -92,7 +92,11 @@ int BVHStackEntry::encodeIdx() const
 BVH::BVH(const BVHParams &params_,
          const vector<Geometry *> &geometry_,
          const vector<Object *> &objects_)
-    : params(params_), geometry(geometry_), objects(objects_)
+    : params(params_),
+      geometry(geometry_),
+      objects(objects_),
+      build_sah_cost(0.0f),
+      sah_cost(0.0f)
 {
 }
 
@@ -173,6 +177,8 @@ void BVH::build(Progress &progress, Stats *)
   progress.set_substatus("Packing BVH nodes");
   pack_nodes(root);
 
+  build_sah_cost = sah_cost = root->computeSubtreeSAHCost(params);
+
   /* free build nodes */
   root->deleteSubtree();
 }
@@ -487,6 +493,10 @@ void BVH::pack_instances(size_t nodes_size, size_t leaf_nodes_size)
           nsize = BVH_UNALIGNED_NODE_SIZE;
           nsize_bbox = 0;
         }
+        else if (bvh_nodes[i].x & PATH_RAY_NODE_QUANTIZED) {
+          nsize = BVH_QUANTIZED_NODE_SIZE;
+          nsize_bbox = 0;
+        }
         else {
           nsize = BVH_NODE_SIZE;
           nsize_bbox = 0;
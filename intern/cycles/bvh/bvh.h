@@ -87,6 +87,12 @@ class BVH {
   vector<Geometry *> geometry;
   vector<Object *> objects;
 
+  /* SAH cost of the tree when it was built and after the last refit. Refitting keeps the tree
+   * topology, so the cost goes up as primitives move away from how they were grouped by the
+   * build. Zero when the BVH layout does not compute it. */
+  float build_sah_cost;
+  float sah_cost;
+
   static BVH *create(const BVHParams &params,
                      const vector<Geometry *> &geometry,
                      const vector<Object *> &objects);
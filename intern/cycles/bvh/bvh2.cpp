@@ -74,13 +74,24 @@ void BVH2::pack_aligned_inner(const BVHStackEntry &e,
                               const BVHStackEntry &e0,
                               const BVHStackEntry &e1)
 {
-  pack_aligned_node(e.idx,
-                    e0.node->bounds,
-                    e1.node->bounds,
-                    e0.encodeIdx(),
-                    e1.encodeIdx(),
-                    e0.node->visibility,
-                    e1.node->visibility);
+  if (params.use_quantized_nodes) {
+    pack_quantized_node(e.idx,
+                        e0.node->bounds,
+                        e1.node->bounds,
+                        e0.encodeIdx(),
+                        e1.encodeIdx(),
+                        e0.node->visibility,
+                        e1.node->visibility);
+  }
+  else {
+    pack_aligned_node(e.idx,
+                      e0.node->bounds,
+                      e1.node->bounds,
+                      e0.encodeIdx(),
+                      e1.encodeIdx(),
+                      e0.node->visibility,
+                      e1.node->visibility);
+  }
 }
 
 void BVH2::pack_aligned_node(int idx,
@@ -95,9 +106,9 @@ void BVH2::pack_aligned_node(int idx,
   assert(c0 < 0 || c0 < pack.nodes.size());
   assert(c1 < 0 || c1 < pack.nodes.size());
 
+  const uint node_flags = PATH_RAY_NODE_UNALIGNED | PATH_RAY_NODE_QUANTIZED;
   int4 data[BVH_NODE_SIZE] = {
-      make_int4(
-          visibility0 & ~PATH_RAY_NODE_UNALIGNED, visibility1 & ~PATH_RAY_NODE_UNALIGNED, c0, c1),
+      make_int4(visibility0 & ~node_flags, visibility1 & ~node_flags, c0, c1),
       make_int4(__float_as_int(b0.min.x),
                 __float_as_int(b1.min.x),
                 __float_as_int(b0.max.x),
@@ -115,6 +126,98 @@ void BVH2::pack_aligned_node(int idx,
   memcpy(&pack.nodes[idx], data, sizeof(int4) * BVH_NODE_SIZE);
 }
 
+/* Largest coordinate quantized nodes can bound, keeps the math below finite for degenerate
+ * bounds of empty or broken geometry. */
+static const float BVH_QUANTIZED_LIMIT = 1e30f;
+
+/* Step of the quantization grid, as the biased float exponent of the smallest power of two for
+ * which 255 steps cover the extent. Powers of two are exact, which keeps the rounding below
+ * predictable, and the kernel can construct them from the exponent directly. */
+static uint bvh_quantized_exponent(float extent)
+{
+  int exponent;
+  frexpf(extent / 255.0f, &exponent);
+  return (uint)clamp(exponent + 127, 1, 254);
+}
+
+static float bvh_quantized_scale(uint exponent)
+{
+  return __uint_as_float(exponent << 23);
+}
+
+/* Round outwards, so the decoded bounds always contain the original ones. The loops only run
+ * when float rounding of the decoding in the kernel ends up on the wrong side. */
+static uint bvh_quantize_lower(float value, float origin, float scale)
+{
+  int q = (int)clamp(floorf((value - origin) / scale), 0.0f, 255.0f);
+  while (q > 0 && origin + scale * (float)q > value) {
+    q--;
+  }
+  return q;
+}
+
+static uint bvh_quantize_upper(float value, float origin, float scale)
+{
+  int q = (int)clamp(ceilf((value - origin) / scale), 0.0f, 255.0f);
+  while (q < 255 && origin + scale * (float)q < value) {
+    q++;
+  }
+  return q;
+}
+
+/* Quantized node, 3 float4 instead of 4:
+ * - Same header as aligned nodes, with visibility and children.
+ * - Origin of the node bounds, and the quantization exponent of every axis.
+ * - For every axis, 8 bit bounds of both children relative to the origin, in the same order as
+ *   the full precision bounds of aligned nodes. */
+void BVH2::pack_quantized_node(int idx,
+                               const BoundBox &b0,
+                               const BoundBox &b1,
+                               int c0,
+                               int c1,
+                               uint visibility0,
+                               uint visibility1)
+{
+  assert(idx + BVH_QUANTIZED_NODE_SIZE <= pack.nodes.size());
+  assert(c0 < 0 || c0 < pack.nodes.size());
+  assert(c1 < 0 || c1 < pack.nodes.size());
+
+  const float3 limit = make_float3(BVH_QUANTIZED_LIMIT);
+  const float3 min0 = clamp(b0.min, -limit, limit);
+  const float3 max0 = clamp(b0.max, -limit, limit);
+  const float3 min1 = clamp(b1.min, -limit, limit);
+  const float3 max1 = clamp(b1.max, -limit, limit);
+  const float3 origin = min(min0, min1);
+  const float3 extent = max(max(max0, max1) - origin, make_float3(0.0f));
+
+  const uint node_flags = PATH_RAY_NODE_UNALIGNED | PATH_RAY_NODE_QUANTIZED;
+  int4 data[BVH_QUANTIZED_NODE_SIZE];
+  data[0] = make_int4((visibility0 & ~node_flags) | PATH_RAY_NODE_QUANTIZED,
+                      (visibility1 & ~node_flags) | PATH_RAY_NODE_QUANTIZED,
+                      c0,
+                      c1);
+
+  uint exponents = 0;
+  uint bounds[3];
+  for (int axis = 0; axis < 3; axis++) {
+    const uint exponent = bvh_quantized_exponent(extent[axis]);
+    const float scale = bvh_quantized_scale(exponent);
+    exponents |= exponent << (axis * 8);
+    bounds[axis] = bvh_quantize_lower(min0[axis], origin[axis], scale) |
+                   (bvh_quantize_lower(min1[axis], origin[axis], scale) << 8) |
+                   (bvh_quantize_upper(max0[axis], origin[axis], scale) << 16) |
+                   (bvh_quantize_upper(max1[axis], origin[axis], scale) << 24);
+  }
+
+  data[1] = make_int4(__float_as_int(origin.x),
+                      __float_as_int(origin.y),
+                      __float_as_int(origin.z),
+                      (int)exponents);
+  data[2] = make_int4(bounds[0], bounds[1], bounds[2], 0);
+
+  memcpy(&pack.nodes[idx], data, sizeof(int4) * BVH_QUANTIZED_NODE_SIZE);
+}
+
 void BVH2::pack_unaligned_inner(const BVHStackEntry &e,
                                 const BVHStackEntry &e0,
                                 const BVHStackEntry &e1)
@@ -147,8 +250,9 @@ void BVH2::pack_unaligned_node(int idx,
   float4 data[BVH_UNALIGNED_NODE_SIZE];
   Transform space0 = BVHUnaligned::compute_node_transform(bounds0, aligned_space0);
   Transform space1 = BVHUnaligned::compute_node_transform(bounds1, aligned_space1);
-  data[0] = make_float4(__int_as_float(visibility0 | PATH_RAY_NODE_UNALIGNED),
-                        __int_as_float(visibility1 | PATH_RAY_NODE_UNALIGNED),
+  data[0] = make_float4(
+      __int_as_float((visibility0 & ~PATH_RAY_NODE_QUANTIZED) | PATH_RAY_NODE_UNALIGNED),
+      __int_as_float((visibility1 & ~PATH_RAY_NODE_QUANTIZED) | PATH_RAY_NODE_UNALIGNED),
                         __int_as_float(c0),
                         __int_as_float(c1));
 
@@ -168,14 +272,16 @@ void BVH2::pack_nodes(const BVHNode *root)
   const size_t num_leaf_nodes = root->getSubtreeSize(BVH_STAT_LEAF_COUNT);
   assert(num_leaf_nodes <= num_nodes);
   const size_t num_inner_nodes = num_nodes - num_leaf_nodes;
+  const size_t aligned_node_size = params.use_quantized_nodes ? BVH_QUANTIZED_NODE_SIZE :
+                                                                 BVH_NODE_SIZE;
   size_t node_size;
   if (params.use_unaligned_nodes) {
     const size_t num_unaligned_nodes = root->getSubtreeSize(BVH_STAT_UNALIGNED_INNER_COUNT);
     node_size = (num_unaligned_nodes * BVH_UNALIGNED_NODE_SIZE) +
-                (num_inner_nodes - num_unaligned_nodes) * BVH_NODE_SIZE;
+                (num_inner_nodes - num_unaligned_nodes) * aligned_node_size;
   }
   else {
-    node_size = num_inner_nodes * BVH_NODE_SIZE;
+    node_size = num_inner_nodes * aligned_node_size;
   }
   /* Resize arrays */
   pack.nodes.clear();
@@ -198,7 +304,7 @@ void BVH2::pack_nodes(const BVHNode *root)
   }
   else {
     stack.push_back(BVHStackEntry(root, nextNodeIdx));
-    nextNodeIdx += root->has_unaligned() ? BVH_UNALIGNED_NODE_SIZE : BVH_NODE_SIZE;
+    nextNodeIdx += inner_node_size(root);
   }
 
   while (stack.size()) {
@@ -219,8 +325,7 @@ void BVH2::pack_nodes(const BVHNode *root)
         }
         else {
           idx[i] = nextNodeIdx;
-          nextNodeIdx += e.node->get_child(i)->has_unaligned() ? BVH_UNALIGNED_NODE_SIZE :
-                                                                 BVH_NODE_SIZE;
+          nextNodeIdx += inner_node_size(e.node->get_child(i));
         }
       }
 
@@ -235,16 +340,31 @@ void BVH2::pack_nodes(const BVHNode *root)
   pack.root_index = (root->is_leaf()) ? -1 : 0;
 }
 
+int BVH2::inner_node_size(const BVHNode *node) const
+{
+  if (node->has_unaligned()) {
+    return BVH_UNALIGNED_NODE_SIZE;
+  }
+  return params.use_quantized_nodes ? BVH_QUANTIZED_NODE_SIZE : BVH_NODE_SIZE;
+}
+
 void BVH2::refit_nodes()
 {
   assert(!params.top_level);
 
   BoundBox bbox = BoundBox::empty;
   uint visibility = 0;
-  refit_node(0, (pack.root_index == -1) ? true : false, bbox, visibility);
+  float cost = 0.0f;
+  refit_node(0, (pack.root_index == -1) ? true : false, bbox, visibility, cost);
+
+  /* Same as BVHNode::computeSubtreeSAHCost(), the area ratios of all nodes along the path from
+   * the root multiply to the area ratio of the node and the root. */
+  const float area = bbox.safe_area();
+  sah_cost = (area > 0.0f) ? cost / area : 0.0f;
 }
 
-void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
+/* Cost is the SAH cost of the subtree, weighted by its surface area. */
+void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility, float &cost)
 {
   if (leaf) {
     /* refit leaf node */
@@ -262,26 +382,33 @@ void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
     leaf_data[0].z = __uint_as_float(visibility);
     leaf_data[0].w = __uint_as_float(data[0].w);
     memcpy(&pack.leaf_nodes[idx], leaf_data, sizeof(float4) * BVH_NODE_LEAF_SIZE);
+
+    cost = bbox.safe_area() * params.cost(0, c1 - c0);
   }
   else {
-    assert(idx + BVH_NODE_SIZE <= pack.nodes.size());
+    assert(idx + BVH_QUANTIZED_NODE_SIZE <= pack.nodes.size());
 
     const int4 *data = &pack.nodes[idx];
     const bool is_unaligned = (data[0].x & PATH_RAY_NODE_UNALIGNED) != 0;
+    const bool is_quantized = (data[0].x & PATH_RAY_NODE_QUANTIZED) != 0;
     const int c0 = data[0].z;
     const int c1 = data[0].w;
     /* refit inner node, set bbox from children */
     BoundBox bbox0 = BoundBox::empty, bbox1 = BoundBox::empty;
     uint visibility0 = 0, visibility1 = 0;
+    float cost0 = 0.0f, cost1 = 0.0f;
 
-    refit_node((c0 < 0) ? -c0 - 1 : c0, (c0 < 0), bbox0, visibility0);
-    refit_node((c1 < 0) ? -c1 - 1 : c1, (c1 < 0), bbox1, visibility1);
+    refit_node((c0 < 0) ? -c0 - 1 : c0, (c0 < 0), bbox0, visibility0, cost0);
+    refit_node((c1 < 0) ? -c1 - 1 : c1, (c1 < 0), bbox1, visibility1, cost1);
 
     if (is_unaligned) {
       Transform aligned_space = transform_identity();
       pack_unaligned_node(
           idx, aligned_space, aligned_space, bbox0, bbox1, c0, c1, visibility0, visibility1);
     }
+    else if (is_quantized) {
+      pack_quantized_node(idx, bbox0, bbox1, c0, c1, visibility0, visibility1);
+    }
     else {
       pack_aligned_node(idx, bbox0, bbox1, c0, c1, visibility0, visibility1);
     }
@@ -289,6 +416,7 @@ void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
     bbox.grow(bbox0);
     bbox.grow(bbox1);
     visibility = visibility0 | visibility1;
+    cost = bbox.safe_area() * params.cost(2, 0) + cost0 + cost1;
   }
 }
 
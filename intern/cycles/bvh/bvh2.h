@@ -37,6 +37,7 @@ class Progress;
 #define BVH_NODE_SIZE 4
 #define BVH_NODE_LEAF_SIZE 1
 #define BVH_UNALIGNED_NODE_SIZE 7
+#define BVH_QUANTIZED_NODE_SIZE 3
 
 /* BVH2
  *
@@ -55,6 +56,7 @@ class BVH2 : public BVH {
 
   /* pack */
   void pack_nodes(const BVHNode *root) override;
+  int inner_node_size(const BVHNode *node) const;
 
   void pack_leaf(const BVHStackEntry &e, const LeafNode *leaf);
   void pack_inner(const BVHStackEntry &e, const BVHStackEntry &e0, const BVHStackEntry &e1);
@@ -70,6 +72,14 @@ class BVH2 : public BVH {
                          uint visibility0,
                          uint visibility1);
 
+  void pack_quantized_node(int idx,
+                           const BoundBox &b0,
+                           const BoundBox &b1,
+                           int c0,
+                           int c1,
+                           uint visibility0,
+                           uint visibility1);
+
   void pack_unaligned_inner(const BVHStackEntry &e,
                             const BVHStackEntry &e0,
                             const BVHStackEntry &e1);
@@ -85,7 +95,7 @@ class BVH2 : public BVH {
 
   /* refit */
   void refit_nodes() override;
-  void refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility);
+  void refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility, float &cost);
 };
 
 CCL_NAMESPACE_END
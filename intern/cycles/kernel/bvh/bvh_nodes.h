@@ -28,6 +28,20 @@ ccl_device_forceinline Transform bvh_unaligned_node_fetch_space(KernelGlobals *k
   return space;
 }
 
+/* Bounds of both children along one axis from quantized node data, in the same order as the
+ * full precision bounds of aligned nodes. */
+ccl_device_forceinline float4 bvh_quantized_node_decode(const uint bounds,
+                                                        const float origin,
+                                                        const uint exponent)
+{
+  const float scale = __uint_as_float((exponent & 0xff) << 23);
+  const float4 q = make_float4((float)(bounds & 0xff),
+                               (float)((bounds >> 8) & 0xff),
+                               (float)((bounds >> 16) & 0xff),
+                               (float)(bounds >> 24));
+  return make_float4(origin, origin, origin, origin) + q * scale;
+}
+
 ccl_device_forceinline int bvh_aligned_node_intersect(KernelGlobals *kg,
                                                       const float3 P,
                                                       const float3 idir,
@@ -38,12 +52,21 @@ ccl_device_forceinline int bvh_aligned_node_intersect(KernelGlobals *kg,
 {
 
   /* fetch node data */
-#ifdef __VISIBILITY_FLAG__
   float4 cnodes = kernel_tex_fetch(__bvh_nodes, node_addr + 0);
-#endif
-  float4 node0 = kernel_tex_fetch(__bvh_nodes, node_addr + 1);
-  float4 node1 = kernel_tex_fetch(__bvh_nodes, node_addr + 2);
-  float4 node2 = kernel_tex_fetch(__bvh_nodes, node_addr + 3);
+  float4 node0, node1, node2;
+  if (__float_as_uint(cnodes.x) & PATH_RAY_NODE_QUANTIZED) {
+    const float4 origin = kernel_tex_fetch(__bvh_nodes, node_addr + 1);
+    const float4 bounds = kernel_tex_fetch(__bvh_nodes, node_addr + 2);
+    const uint exponents = __float_as_uint(origin.w);
+    node0 = bvh_quantized_node_decode(__float_as_uint(bounds.x), origin.x, exponents);
+    node1 = bvh_quantized_node_decode(__float_as_uint(bounds.y), origin.y, exponents >> 8);
+    node2 = bvh_quantized_node_decode(__float_as_uint(bounds.z), origin.z, exponents >> 16);
+  }
+  else {
+    node0 = kernel_tex_fetch(__bvh_nodes, node_addr + 1);
+    node1 = kernel_tex_fetch(__bvh_nodes, node_addr + 2);
+    node2 = kernel_tex_fetch(__bvh_nodes, node_addr + 3);
+  }
 
   /* intersect ray against child nodes */
   float c0lox = (node0.x - P.x) * idir.x;
@@ -15,6 +15,7 @@
  */
 
 #include "kernel_light_background.h"
+#include "kernel_light_tree.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -153,8 +154,7 @@ ccl_device_inline bool lamp_light_sample(
     }
   }
 
-  ls->pdf *= kernel_data.integrator.pdf_lights;
-
+  /* Probability of having picked the lamp is applied by light_sample(). */
   return (ls->pdf > 0.0f);
 }
 
@@ -291,6 +291,13 @@ ccl_device bool lamp_light_eval(
     return false;
   }
 
+#ifdef __LIGHT_TREE__
+  if (kernel_data.integrator.use_light_tree) {
+    ls->pdf *= light_tree_lamp_pdf(kg, lamp, P);
+    return true;
+  }
+#endif
+
   ls->pdf *= kernel_data.integrator.pdf_lights;
 
   return true;
@@ -328,12 +335,12 @@ ccl_device_inline bool triangle_world_space_vertices(
   return has_motion;
 }
 
-ccl_device_inline float triangle_light_pdf_area(KernelGlobals *kg,
-                                                const float3 Ng,
+/* Convert a pdf over the triangle area to solid angle. */
+ccl_device_inline float triangle_light_pdf_area(const float3 Ng,
                                                 const float3 I,
-                                                float t)
+                                                float t,
+                                                float pdf)
 {
-  float pdf = kernel_data.integrator.pdf_triangles;
   float cos_pi = fabsf(dot(Ng, I));
 
   if (cos_pi == 0.0f)
@@ -379,6 +386,11 @@ ccl_device_forceinline float triangle_light_pdf(KernelGlobals *kg, ShaderData *s
     if (UNLIKELY(solid_angle == 0.0f)) {
       return 0.0f;
     }
+#ifdef __LIGHT_TREE__
+    else if (kernel_data.integrator.use_light_tree) {
+      return light_tree_triangle_pdf(kg, sd->object, sd->prim, Px) / solid_angle;
+    }
+#endif
     else {
       float area = 1.0f;
       if (has_motion) {
@@ -393,8 +405,19 @@ ccl_device_forceinline float triangle_light_pdf(KernelGlobals *kg, ShaderData *s
       return pdf / solid_angle;
     }
   }
+#ifdef __LIGHT_TREE__
+  else if (kernel_data.integrator.use_light_tree) {
+    const float area = 0.5f * len(N);
+    if (UNLIKELY(area == 0.0f)) {
+      return 0.0f;
+    }
+    const float3 Px = sd->P + sd->I * t;
+    const float pdf = light_tree_triangle_pdf(kg, sd->object, sd->prim, Px) / area;
+    return triangle_light_pdf_area(sd->Ng, sd->I, t, pdf);
+  }
+#endif
   else {
-    float pdf = triangle_light_pdf_area(kg, sd->Ng, sd->I, t);
+    float pdf = triangle_light_pdf_area(sd->Ng, sd->I, t, kernel_data.integrator.pdf_triangles);
     if (has_motion) {
       const float area = 0.5f * len(N);
       if (UNLIKELY(area == 0.0f)) {
@@ -536,6 +559,11 @@ ccl_device_forceinline void triangle_light_sample(KernelGlobals *kg,
       ls->pdf = 0.0f;
       return;
     }
+#ifdef __LIGHT_TREE__
+    else if (kernel_data.integrator.use_light_tree) {
+      ls->pdf = 1.0f / solid_angle;
+    }
+#endif
     else {
       if (has_motion) {
         /* get the center frame vertices, this is what the PDF was calculated from */
@@ -564,14 +592,24 @@ ccl_device_forceinline void triangle_light_sample(KernelGlobals *kg,
     ls->P = u * V[0] + v * V[1] + t * V[2];
     /* compute incoming direction, distance and pdf */
     ls->D = normalize_len(ls->P - P, &ls->t);
-    ls->pdf = triangle_light_pdf_area(kg, ls->Ng, -ls->D, ls->t);
-    if (has_motion && area != 0.0f) {
-      /* scale the PDF.
-       * area = the area the sample was taken from
-       * area_pre = the are from which pdf_triangles was calculated from */
-      triangle_world_space_vertices(kg, object, prim, -1.0f, V);
-      const float area_pre = triangle_area(V[0], V[1], V[2]);
-      ls->pdf = ls->pdf * area_pre / area;
+#ifdef __LIGHT_TREE__
+    if (kernel_data.integrator.use_light_tree) {
+      ls->pdf = (area != 0.0f) ? triangle_light_pdf_area(ls->Ng, -ls->D, ls->t, 1.0f / area) :
+                                 0.0f;
+    }
+    else
+#endif
+    {
+      ls->pdf = triangle_light_pdf_area(
+          ls->Ng, -ls->D, ls->t, kernel_data.integrator.pdf_triangles);
+      if (has_motion && area != 0.0f) {
+        /* scale the PDF.
+         * area = the area the sample was taken from
+         * area_pre = the are from which pdf_triangles was calculated from */
+        triangle_world_space_vertices(kg, object, prim, -1.0f, V);
+        const float area_pre = triangle_area(V[0], V[1], V[2]);
+        ls->pdf = ls->pdf * area_pre / area;
+      }
     }
     ls->u = u;
     ls->v = v;
@@ -632,9 +670,18 @@ ccl_device_noinline bool light_sample(KernelGlobals *kg,
                                       int bounce,
                                       LightSample *ls)
 {
+  /* Probability of picking the light. */
+  float pdf_select = kernel_data.integrator.pdf_lights;
+
   if (lamp < 0) {
     /* sample index */
+#ifdef __LIGHT_TREE__
+    int index = (kernel_data.integrator.use_light_tree) ?
+                    light_tree_sample(kg, P, &randu, &pdf_select) :
+                    light_distribution_sample(kg, &randu);
+#else
     int index = light_distribution_sample(kg, &randu);
+#endif
 
     /* fetch light data */
     const ccl_global KernelLightDistribution *kdistribution = &kernel_tex_fetch(
@@ -647,6 +694,12 @@ ccl_device_noinline bool light_sample(KernelGlobals *kg,
 
       triangle_light_sample(kg, prim, object, randu, randv, time, ls, P);
       ls->shader |= shader_flag;
+#ifdef __LIGHT_TREE__
+      /* Without the light tree the triangle pdf includes picking it by area. */
+      if (kernel_data.integrator.use_light_tree) {
+        ls->pdf *= pdf_select;
+      }
+#endif
       return (ls->pdf > 0.0f);
     }
 
@@ -657,7 +710,12 @@ ccl_device_noinline bool light_sample(KernelGlobals *kg,
     return false;
   }
 
-  return lamp_light_sample(kg, lamp, randu, randv, P, ls);
+  if (!lamp_light_sample(kg, lamp, randu, randv, P, ls)) {
+    return false;
+  }
+
+  ls->pdf *= pdf_select;
+  return (ls->pdf > 0.0f);
 }
 
 ccl_device_inline int light_select_num_samples(KernelGlobals *kg, int index)
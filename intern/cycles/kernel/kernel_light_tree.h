@@ -0,0 +1,173 @@
+/*
+ * Copyright 2011-2020 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+CCL_NAMESPACE_BEGIN
+
+/* Light Tree
+ *
+ * Picks a single light proportional to an estimate of its contribution to the shading point,
+ * by walking down the tree built in render/light_tree.cpp. Distant and background lights are
+ * not in the tree, they are picked uniformly with the same probability as with the light
+ * distribution.
+ *
+ * The leaf map contains, in order:
+ * - For every light, its leaf node, or -1 for distant and background lights.
+ * - For every distant and background light, its index in the light distribution.
+ * - For every object, the offset of its triangles in the leaf map or -1 if it has no mesh
+ *   lights, followed by the primitive offset of its mesh.
+ * - For every triangle of those objects, its leaf node or -1 if it does not emit light. */
+
+#ifdef __LIGHT_TREE__
+
+/* Estimate of how much light the emitters of a node contribute to P. */
+ccl_device float light_tree_node_importance(KernelGlobals *kg, int index, float3 P)
+{
+  const ccl_global KernelLightTreeNode *knode = &kernel_tex_fetch(__light_tree_nodes, index);
+  if (knode->energy == 0.0f) {
+    return 0.0f;
+  }
+
+  const float3 bbox_min = make_float3(knode->bbox_min[0], knode->bbox_min[1], knode->bbox_min[2]);
+  const float3 bbox_max = make_float3(knode->bbox_max[0], knode->bbox_max[1], knode->bbox_max[2]);
+  const float3 centroid = 0.5f * (bbox_min + bbox_max);
+  const float radius_sq = 0.25f * len_squared(bbox_max - bbox_min);
+  const float distance_sq = len_squared(P - centroid);
+
+  float theta_prime = 0.0f;
+  if (distance_sq > radius_sq) {
+    /* Smallest angle between the emitter normals and the direction to P, from any point in the
+     * bounding sphere of the node. */
+    const float3 axis = make_float3(knode->axis[0], knode->axis[1], knode->axis[2]);
+    const float cos_theta = dot(axis, (P - centroid) / sqrtf(distance_sq));
+    const float theta = fast_acosf(clamp(cos_theta, -1.0f, 1.0f));
+    const float theta_u = fast_asinf(sqrtf(radius_sq / distance_sq));
+    theta_prime = max(theta - knode->theta_o - theta_u, 0.0f);
+    if (theta_prime >= knode->theta_e) {
+      return 0.0f;
+    }
+  }
+
+  /* Don't let the distance drop below the size of the node, points inside it would get a
+   * meaningless estimate otherwise. */
+  return knode->energy * fast_cosf(theta_prime) / max(max(distance_sq, radius_sq), 1e-12f);
+}
+
+/* Probability of descending into the first child of an inner node. */
+ccl_device float light_tree_first_child_probability(KernelGlobals *kg, int index, float3 P)
+{
+  const int second_child = kernel_tex_fetch(__light_tree_nodes, index).child;
+  const float importance_first = light_tree_node_importance(kg, index + 1, P);
+  const float importance_second = light_tree_node_importance(kg, second_child, P);
+  const float importance = importance_first + importance_second;
+
+  if (importance == 0.0f) {
+    /* Neither child can light P, it does not matter which one is picked. */
+    return 0.5f;
+  }
+  return importance_first / importance;
+}
+
+/* Probability of picking a distant or background light. */
+ccl_device_inline float light_tree_infinite_pdf(KernelGlobals *kg)
+{
+  return kernel_data.integrator.num_light_tree_infinite * kernel_data.integrator.pdf_lights;
+}
+
+/* Pick a light for P, returns its index in the light distribution. randu is rescaled to be
+ * reused for sampling the light. */
+ccl_device int light_tree_sample(KernelGlobals *kg, float3 P, float *randu, float *pdf)
+{
+  const int num_infinite = kernel_data.integrator.num_light_tree_infinite;
+  const float pdf_infinite = light_tree_infinite_pdf(kg);
+  float r = *randu;
+
+  if (r < pdf_infinite || num_infinite == kernel_data.integrator.num_distribution) {
+    r = r * num_infinite / pdf_infinite;
+    const int i = min((int)r, num_infinite - 1);
+    *randu = r - i;
+    *pdf = kernel_data.integrator.pdf_lights;
+    return kernel_tex_fetch(__light_tree_leaf_map, kernel_data.integrator.num_all_lights + i);
+  }
+
+  r = (r - pdf_infinite) / (1.0f - pdf_infinite);
+  float tree_pdf = 1.0f - pdf_infinite;
+
+  int index = 0;
+  int child;
+  while ((child = kernel_tex_fetch(__light_tree_nodes, index).child) >= 0) {
+    const float probability = light_tree_first_child_probability(kg, index, P);
+    if (r < probability) {
+      r = r / probability;
+      tree_pdf *= probability;
+      index = index + 1;
+    }
+    else {
+      r = (r - probability) / (1.0f - probability);
+      tree_pdf *= 1.0f - probability;
+      index = child;
+    }
+  }
+
+  *randu = r;
+  *pdf = tree_pdf;
+  return -child - 1;
+}
+
+/* Probability of picking the light of a leaf node for P. */
+ccl_device float light_tree_leaf_pdf(KernelGlobals *kg, int leaf, float3 P)
+{
+  float pdf = 1.0f - light_tree_infinite_pdf(kg);
+
+  int index = leaf;
+  while (index != 0) {
+    const int parent = kernel_tex_fetch(__light_tree_nodes, index).parent;
+    const float probability = light_tree_first_child_probability(kg, parent, P);
+    pdf *= (index == parent + 1) ? probability : 1.0f - probability;
+    index = parent;
+  }
+
+  return pdf;
+}
+
+ccl_device float light_tree_lamp_pdf(KernelGlobals *kg, int lamp, float3 P)
+{
+  const int leaf = kernel_tex_fetch(__light_tree_leaf_map, lamp);
+  if (leaf == -1) {
+    return kernel_data.integrator.pdf_lights;
+  }
+  return light_tree_leaf_pdf(kg, leaf, P);
+}
+
+ccl_device float light_tree_triangle_pdf(KernelGlobals *kg, int object, int prim, float3 P)
+{
+  const int object_offset = kernel_data.integrator.num_all_lights +
+                            kernel_data.integrator.num_light_tree_infinite + object * 2;
+  const int triangles_offset = kernel_tex_fetch(__light_tree_leaf_map, object_offset);
+  if (triangles_offset == -1) {
+    return 0.0f;
+  }
+
+  const int prim_offset = kernel_tex_fetch(__light_tree_leaf_map, object_offset + 1);
+  const int leaf = kernel_tex_fetch(__light_tree_leaf_map, triangles_offset + prim - prim_offset);
+  if (leaf == -1) {
+    return 0.0f;
+  }
+  return light_tree_leaf_pdf(kg, leaf, P);
+}
+
+#endif /* __LIGHT_TREE__ */
+
+CCL_NAMESPACE_END
@@ -109,6 +109,7 @@ CCL_NAMESPACE_BEGIN
 #  define __TRANSPARENT_SHADOWS__
 #  define __BACKGROUND_MIS__
 #  define __LAMP_MIS__
+#  define __LIGHT_TREE__
 #  define __CAMERA_MOTION__
 #  define __OBJECT_MOTION__
 #  define __BAKING__
@@ -128,6 +129,7 @@ CCL_NAMESPACE_BEGIN
 #  endif
 #  define __VOLUME_DECOUPLED__
 #  define __VOLUME_RECORD_ALL__
+#  define __TEXTURE_CACHE__
 #endif /* __KERNEL_CPU__ */
 
 #ifdef __KERNEL_CUDA__
@@ -289,8 +291,8 @@ enum PathRayFlag {
                                  PATH_RAY_SHADOW_TRANSPARENT_NON_CATCHER),
   PATH_RAY_SHADOW = (PATH_RAY_SHADOW_OPAQUE | PATH_RAY_SHADOW_TRANSPARENT),
 
-  /* Unused, free to reuse. */
-  PATH_RAY_UNUSED = (1 << 11),
+  /* Special flag to tag quantized BVH nodes. */
+  PATH_RAY_NODE_QUANTIZED = (1 << 11),
 
   /* Ray visibility for volume scattering. */
   PATH_RAY_VOLUME_SCATTER = (1 << 12),
@@ -1389,7 +1391,9 @@ typedef struct KernelIntegrator {
 
   int max_closures;
 
-  int pad1, pad2;
+  /* light tree */
+  int use_light_tree;
+  int num_light_tree_infinite;
 } KernelIntegrator;
 static_assert_align(KernelIntegrator, 16);
 
@@ -1548,6 +1552,26 @@ typedef struct KernelLightDistribution {
 } KernelLightDistribution;
 static_assert_align(KernelLightDistribution, 16);
 
+/* Node of the light tree. Nodes are stored depth first, so the first child of an inner node
+ * directly follows it. The bounds are used to estimate the importance of the node for a
+ * shading point. */
+typedef struct KernelLightTreeNode {
+  float bbox_min[3];
+  float energy;
+  float bbox_max[3];
+  /* Normals of the emitters are within theta_o of the axis, and light leaves them at most
+   * theta_e away from the normal. */
+  float theta_o;
+  float axis[3];
+  float theta_e;
+  /* Index of the second child for inner nodes, -1 - index into the light distribution for
+   * leaves. */
+  int child;
+  int parent;
+  int pad1, pad2;
+} KernelLightTreeNode;
+static_assert_align(KernelLightTreeNode, 16);
+
 typedef struct KernelParticle {
   int index;
   float age;
@@ -192,15 +192,25 @@ void Geometry::compute_bvh(
     vector<Object *> objects;
     objects.push_back(&object);
 
-    if (bvh && !need_update_rebuild) {
+    bool rebuild = !bvh || need_update_rebuild;
+
+    if (!rebuild) {
       progress->set_status(msg, "Refitting BVH");
 
       bvh->geometry = geometry;
       bvh->objects = objects;
 
       bvh->refit(*progress);
+
+      /* Rebuild when the tree got too inefficient for the deformed geometry. */
+      if (bvh->sah_cost > bvh->build_sah_cost * params->bvh_refit_max_cost_ratio) {
+        VLOG(1) << "Refitted BVH of " << name << " has SAH cost " << bvh->sah_cost
+                << " compared to " << bvh->build_sah_cost << " when built, rebuilding.";
+        rebuild = true;
+      }
     }
-    else {
+
+    if (rebuild) {
       progress->set_status(msg, "Building BVH");
 
       BVHParams bparams;
@@ -208,6 +218,7 @@ void Geometry::compute_bvh(
       bparams.bvh_layout = bvh_layout;
       bparams.use_unaligned_nodes = dscene->data.bvh.have_curves &&
                                     params->use_bvh_unaligned_nodes;
+      bparams.use_quantized_nodes = params->use_bvh_quantized_nodes;
       bparams.num_motion_triangle_steps = params->num_bvh_time_steps;
       bparams.num_motion_curve_steps = params->num_bvh_time_steps;
       bparams.bvh_type = params->bvh_type;
@@ -1022,6 +1033,7 @@ void GeometryManager::device_update_bvh(Device *device,
   bparams.use_spatial_split = scene->params.use_bvh_spatial_split;
   bparams.use_unaligned_nodes = dscene->data.bvh.have_curves &&
                                 scene->params.use_bvh_unaligned_nodes;
+  bparams.use_quantized_nodes = scene->params.use_bvh_quantized_nodes;
   bparams.num_motion_triangle_steps = scene->params.num_bvh_time_steps;
   bparams.num_motion_curve_steps = scene->params.num_bvh_time_steps;
   bparams.bvh_type = scene->params.bvh_type;
@@ -380,6 +380,9 @@ void ShaderGraph::finalize(Scene *scene, bool do_bump, bool do_simplify, bool bu
   if (!finalized) {
     simplify(scene);
 
+    if (scene->image_manager->use_texture_cache() && !scene->shader_manager->use_osl())
+      image_texture_derivatives();
+
     if (do_bump)
       bump_from_displacement(bump_in_object_space);
 
@@ -953,6 +956,63 @@ void ShaderGraph::refine_bump_nodes()
   }
 }
 
+void ShaderGraph::image_texture_derivatives()
+{
+  /* the texture cache needs derivatives of the texture coordinates to pick
+   * mipmap levels. like for bump mapping we copy the sub-graph defining the
+   * vector of image texture nodes twice, with texture coordinates shifted by
+   * the ray differentials, and connect them to the "VectorDX" and "VectorDY"
+   * inputs. */
+
+  foreach (ShaderNode *node, nodes) {
+    if (node->type != ImageTextureNode::node_type ||
+        ((ImageTextureNode *)node)->projection != NODE_IMAGE_PROJ_FLAT) {
+      continue;
+    }
+
+    ShaderInput *vector_in = node->input("Vector");
+    if (!vector_in->link) {
+      continue;
+    }
+
+    ShaderNodeSet nodes_vector;
+    find_dependencies(nodes_vector, vector_in);
+
+    /* don't copy other image textures, that would multiply texture lookups
+     * and they would not get derivatives themselves anyway */
+    bool has_image_texture = false;
+    foreach (ShaderNode *dependency, nodes_vector) {
+      if (dependency->special_type == SHADER_SPECIAL_TYPE_IMAGE_SLOT) {
+        has_image_texture = true;
+        break;
+      }
+    }
+    if (has_image_texture) {
+      continue;
+    }
+
+    ShaderNodeMap nodes_dx;
+    ShaderNodeMap nodes_dy;
+
+    copy_nodes(nodes_vector, nodes_dx);
+    copy_nodes(nodes_vector, nodes_dy);
+
+    foreach (NodePair &pair, nodes_dx)
+      pair.second->bump = SHADER_BUMP_DX;
+    foreach (NodePair &pair, nodes_dy)
+      pair.second->bump = SHADER_BUMP_DY;
+
+    ShaderOutput *out = vector_in->link;
+    connect(nodes_dx[out->parent]->output(out->name()), node->input("VectorDX"));
+    connect(nodes_dy[out->parent]->output(out->name()), node->input("VectorDY"));
+
+    foreach (NodePair &pair, nodes_dx)
+      add(pair.second);
+    foreach (NodePair &pair, nodes_dy)
+      add(pair.second);
+  }
+}
+
 void ShaderGraph::bump_from_displacement(bool use_object_space)
 {
   /* generate bump mapping automatically from displacement. bump mapping is
@@ -30,6 +30,7 @@
 #include "util/util_progress.h"
 #include "util/util_task.h"
 #include "util/util_texture.h"
+#include "util/util_texture_cache.h"
 #include "util/util_unique_ptr.h"
 
 #ifdef WITH_OSL
@@ -291,7 +292,8 @@ bool ImageLoader::is_vdb_loader() const
 
 /* Image Manager */
 
-ImageManager::ImageManager(const DeviceInfo &info)
+ImageManager::ImageManager(const DeviceInfo &info, const TextureCacheParams &texture_cache_params)
+    : texture_cache_params(texture_cache_params)
 {
   need_update = true;
   osl_texture_system = NULL;
@@ -299,6 +301,12 @@ ImageManager::ImageManager(const DeviceInfo &info)
 
   /* Set image limits */
   has_half_images = info.has_half_images;
+
+  /* The kernel calls into the texture cache directly, so it only works on the CPU. */
+  if (texture_cache_params.use_cache && info.type == DEVICE_CPU) {
+    texture_cache.reset(
+        new TextureCache(texture_cache_params.cache_size, texture_cache_params.tile_size));
+  }
 }
 
 ImageManager::~ImageManager()
@@ -312,6 +320,11 @@ void ImageManager::set_osl_texture_system(void *texture_system)
   osl_texture_system = texture_system;
 }
 
+bool ImageManager::use_texture_cache() const
+{
+  return (bool)texture_cache;
+}
+
 bool ImageManager::set_animation_frame_update(int frame)
 {
   if (frame != animation_frame) {
@@ -641,6 +654,36 @@ bool ImageManager::file_load_image(Image *img, int texture_limit)
   return true;
 }
 
+/* Open the image file in the texture cache instead of loading all pixels. Color space
+ * conversion and alpha handling are done while loading pixels, so this is limited to images
+ * that need no conversion beyond what the kernel and the texture system do. */
+bool ImageManager::load_image_texture_cache(Image *img)
+{
+  if (!texture_cache) {
+    return false;
+  }
+
+  const ustring filepath = img->loader->osl_filepath();
+  if (filepath.empty()) {
+    return false;
+  }
+
+  const ImageMetaData &metadata = img->metadata;
+  if (metadata.colorspace != u_colorspace_raw && metadata.colorspace != u_colorspace_srgb) {
+    return false;
+  }
+
+  /* The texture system always associates alpha. */
+  const bool has_alpha = (metadata.channels == 2 || metadata.channels == 4);
+  if (has_alpha && !image_associate_alpha(img)) {
+    return false;
+  }
+
+  img->mem->info.cache_handle = texture_cache->open(
+      filepath.string(), texture_cache_params.auto_convert, texture_cache_params.cache_path);
+  return img->mem->info.cache_handle != 0;
+}
+
 void ImageManager::device_load_image(Device *device, Scene *scene, int slot, Progress *progress)
 {
   if (progress->get_cancel()) {
@@ -661,6 +704,10 @@ void ImageManager::device_load_image(Device *device, Scene *scene, int slot, Pro
 
   /* Free previous texture in slot. */
   if (img->mem) {
+    if (img->mem->info.cache_handle) {
+      texture_cache->invalidate(img->mem->info.cache_handle);
+    }
+
     thread_scoped_lock device_lock(device_mutex);
     delete img->mem;
     img->mem = NULL;
@@ -672,7 +719,13 @@ void ImageManager::device_load_image(Device *device, Scene *scene, int slot, Pro
   img->mem->info.transform_3d = img->metadata.transform_3d;
 
   /* Create new texture. */
-  if (type == IMAGE_DATA_TYPE_FLOAT4) {
+  if (load_image_texture_cache(img)) {
+    /* Pixels are read by the kernel through the texture cache, only keep a placeholder. */
+    thread_scoped_lock device_lock(device_mutex);
+    void *pixels = img->mem->alloc(1, 1);
+    memset(pixels, 0, img->mem->memory_size());
+  }
+  else if (type == IMAGE_DATA_TYPE_FLOAT4) {
     if (!file_load_image<TypeDesc::FLOAT, float>(img, texture_limit)) {
       /* on failure to load, we set a 1x1 pixels pink image */
       thread_scoped_lock device_lock(device_mutex);
@@ -784,6 +837,10 @@ void ImageManager::device_free_image(Device *, int slot)
   }
 
   if (img->mem) {
+    if (img->mem->info.cache_handle) {
+      texture_cache->invalidate(img->mem->info.cache_handle);
+    }
+
     thread_scoped_lock device_lock(device_mutex);
     delete img->mem;
   }
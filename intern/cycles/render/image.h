@@ -39,6 +39,7 @@ class Progress;
 class RenderStats;
 class Scene;
 class ColorSpaceProcessor;
+class TextureCache;
 class VDBImageLoader;
 
 /* Image Parameters */
@@ -69,6 +70,35 @@ class ImageParams {
   }
 };
 
+/* Texture Cache Parameters
+ *
+ * Settings for reading image files on demand through a tiled and mipmapped texture cache,
+ * rather than loading them fully before rendering. Only supported on the CPU. */
+class TextureCacheParams {
+ public:
+  bool use_cache;
+  /* Maximum memory used by the cache, in megabytes. */
+  int cache_size;
+  /* Tile size used for images that are not tiled on disk. */
+  int tile_size;
+  /* Convert images to tiled and mipmapped .tx files before rendering. */
+  bool auto_convert;
+  /* Directory for converted files, next to the original image if empty. */
+  string cache_path;
+
+  TextureCacheParams()
+      : use_cache(false), cache_size(1024), tile_size(64), auto_convert(false), cache_path("")
+  {
+  }
+
+  bool operator==(const TextureCacheParams &other) const
+  {
+    return (use_cache == other.use_cache && cache_size == other.cache_size &&
+            tile_size == other.tile_size && auto_convert == other.auto_convert &&
+            cache_path == other.cache_path);
+  }
+};
+
 /* Image MetaData
  *
  * Information about the image that is available before the image pixels are loaded. */
@@ -167,7 +197,7 @@ class ImageHandle {
  * texture images and 3D volume images. */
 class ImageManager {
  public:
-  explicit ImageManager(const DeviceInfo &info);
+  ImageManager(const DeviceInfo &info, const TextureCacheParams &texture_cache_params);
   ~ImageManager();
 
   ImageHandle add_image(const string &filename, const ImageParams &params);
@@ -186,6 +216,8 @@ class ImageManager {
   void set_osl_texture_system(void *texture_system);
   bool set_animation_frame_update(int frame);
 
+  bool use_texture_cache() const;
+
   void collect_statistics(RenderStats *stats);
 
   bool need_update;
@@ -217,11 +249,15 @@ class ImageManager {
   vector<Image *> images;
   void *osl_texture_system;
 
+  TextureCacheParams texture_cache_params;
+  unique_ptr<TextureCache> texture_cache;
+
   int add_image_slot(ImageLoader *loader, const ImageParams &params, const bool builtin);
   void add_image_user(int slot);
   void remove_image_user(int slot);
 
   void load_image_metadata(Image *img);
+  bool load_image_texture_cache(Image *img);
 
   template<TypeDesc::BASETYPE FileFormat, typename StorageType>
   bool file_load_image(Image *img, int texture_limit);
@@ -77,6 +77,7 @@ NODE_DEFINE(Integrator)
   SOCKET_BOOLEAN(sample_all_lights_direct, "Sample All Lights Direct", true);
   SOCKET_BOOLEAN(sample_all_lights_indirect, "Sample All Lights Indirect", true);
   SOCKET_FLOAT(light_sampling_threshold, "Light Sampling Threshold", 0.05f);
+  SOCKET_BOOLEAN(use_light_tree, "Use Light Tree", false);
 
   static NodeEnum method_enum;
   method_enum.insert("path", PATH);
@@ -181,6 +182,11 @@ void Integrator::device_update(Device *device, DeviceScene *dscene, Scene *scene
     kintegrator->sample_all_lights_indirect = false;
   }
 
+  /* Sampling all lights relies on the area based light distribution, the light tree only
+   * replaces picking a single light. */
+  kintegrator->use_light_tree = use_light_tree && !kintegrator->sample_all_lights_direct &&
+                                !kintegrator->sample_all_lights_indirect;
+
   kintegrator->sampling_pattern = sampling_pattern;
   kintegrator->aa_samples = aa_samples;
   if (aa_samples > 0 && adaptive_min_samples == 0) {
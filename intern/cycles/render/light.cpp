@@ -20,6 +20,7 @@
 #include "render/film.h"
 #include "render/graph.h"
 #include "render/integrator.h"
+#include "render/light_tree.h"
 #include "render/mesh.h"
 #include "render/nodes.h"
 #include "render/object.h"
@@ -247,6 +248,48 @@ void LightManager::test_enabled_lights(Scene *scene)
   }
 }
 
+/* Rough estimate of the radiance emitted by a shader, for the light tree. */
+static float light_tree_shader_emission(Shader *shader)
+{
+  float3 emission;
+  if (shader->is_constant_emission(&emission)) {
+    return fabsf(average(emission));
+  }
+  /* Unknown emission, assume unit strength. */
+  return 1.0f;
+}
+
+static LightTreeEmitter light_tree_emitter_from_light(Scene *scene,
+                                                      Light *light,
+                                                      int distribution_index)
+{
+  BoundBox bounds = BoundBox::empty;
+  LightTreeCone cone = LightTreeCone::omnidirectional();
+
+  if (light->type == LIGHT_AREA) {
+    const float3 axisu = light->axisu * (light->sizeu * light->size * 0.5f);
+    const float3 axisv = light->axisv * (light->sizev * light->size * 0.5f);
+    bounds.grow(light->co - axisu - axisv);
+    bounds.grow(light->co - axisu + axisv);
+    bounds.grow(light->co + axisu - axisv);
+    bounds.grow(light->co + axisu + axisv);
+    cone = LightTreeCone(safe_normalize(light->dir), 0.0f, M_PI_2_F);
+  }
+  else {
+    bounds.grow(light->co, light->size);
+    if (light->type == LIGHT_SPOT) {
+      cone = LightTreeCone(
+          safe_normalize(light->dir), 0.0f, min(light->spot_angle * 0.5f, M_PI_F));
+    }
+  }
+
+  /* Light strength is the emitted power, same as estimated for mesh lights. */
+  Shader *shader = (light->shader) ? light->shader : scene->default_light;
+  const float energy = fabsf(average(light->strength)) * light_tree_shader_emission(shader);
+
+  return LightTreeEmitter(bounds, cone, energy, distribution_index);
+}
+
 bool LightManager::object_usable_as_light(Object *object)
 {
   Geometry *geom = object->geometry;
@@ -283,6 +326,7 @@ void LightManager::device_update_distribution(Device *,
 
   /* count */
   size_t num_lights = 0;
+  size_t num_infinite_lights = 0;
   size_t num_portals = 0;
   size_t num_background_lights = 0;
   size_t num_triangles = 0;
@@ -292,6 +336,9 @@ void LightManager::device_update_distribution(Device *,
   foreach (Light *light, scene->lights) {
     if (light->is_enabled) {
       num_lights++;
+      if (light->type == LIGHT_DISTANT || light->type == LIGHT_BACKGROUND) {
+        num_infinite_lights++;
+      }
     }
     if (light->is_portal) {
       num_portals++;
@@ -328,6 +375,20 @@ void LightManager::device_update_distribution(Device *,
   KernelLightDistribution *distribution = dscene->light_distribution.alloc(num_distribution + 1);
   float totarea = 0.0f;
 
+  /* Light tree over triangles and lights with a position, distant and background lights are
+   * picked uniformly as with the distribution. The leaf map finds the tree leaf of lights and
+   * triangles for multiple importance sampling, see kernel_light_tree.h for its layout. Until
+   * the tree is built it holds indices into the distribution. */
+  const bool use_light_tree = scene->integrator->use_light_tree;
+  vector<LightTreeEmitter> tree_emitters;
+  vector<int> leaf_map;
+  const size_t leaf_map_objects_offset = num_lights + num_infinite_lights;
+
+  if (use_light_tree) {
+    tree_emitters.reserve(num_distribution);
+    leaf_map.resize(leaf_map_objects_offset + scene->objects.size() * 2, -1);
+  }
+
   /* triangles */
   size_t offset = 0;
   int j = 0;
@@ -365,6 +426,21 @@ void LightManager::device_update_distribution(Device *,
     }
 
     size_t mesh_num_triangles = mesh->num_triangles();
+    size_t leaf_map_triangles_offset = 0;
+    vector<float> shader_emission;
+
+    if (use_light_tree) {
+      leaf_map_triangles_offset = leaf_map.size();
+      leaf_map[leaf_map_objects_offset + object_id * 2] = leaf_map_triangles_offset;
+      leaf_map[leaf_map_objects_offset + object_id * 2 + 1] = mesh->prim_offset;
+      leaf_map.resize(leaf_map_triangles_offset + mesh_num_triangles, -1);
+
+      foreach (Shader *shader, mesh->used_shaders) {
+        shader_emission.push_back(light_tree_shader_emission(shader));
+      }
+      shader_emission.push_back(light_tree_shader_emission(scene->default_surface));
+    }
+
     for (size_t i = 0; i < mesh_num_triangles; i++) {
       int shader_index = mesh->shader[i];
       Shader *shader = (shader_index < mesh->used_shaders.size()) ?
@@ -392,7 +468,22 @@ void LightManager::device_update_distribution(Device *,
           p3 = transform_point(&tfm, p3);
         }
 
-        totarea += triangle_area(p1, p2, p3);
+        const float area = triangle_area(p1, p2, p3);
+        totarea += area;
+
+        if (use_light_tree) {
+          BoundBox bounds = BoundBox::empty;
+          bounds.grow(p1);
+          bounds.grow(p2);
+          bounds.grow(p3);
+          /* Mesh lights emit from both sides. */
+          const float emission = (shader_index < mesh->used_shaders.size()) ?
+                                     shader_emission[shader_index] :
+                                     shader_emission.back();
+          tree_emitters.push_back(LightTreeEmitter(
+              bounds, LightTreeCone::omnidirectional(), M_PI_F * area * emission, offset - 1));
+          leaf_map[leaf_map_triangles_offset + i] = offset - 1;
+        }
       }
     }
 
@@ -406,6 +497,7 @@ void LightManager::device_update_distribution(Device *,
   bool use_lamp_mis = false;
 
   int light_index = 0;
+  int infinite_light_index = 0;
   foreach (Light *light, scene->lights) {
     if (!light->is_enabled)
       continue;
@@ -416,6 +508,16 @@ void LightManager::device_update_distribution(Device *,
     distribution[offset].lamp.size = light->size;
     totarea += lightarea;
 
+    if (use_light_tree) {
+      if (light->type == LIGHT_DISTANT || light->type == LIGHT_BACKGROUND) {
+        leaf_map[num_lights + infinite_light_index++] = offset;
+      }
+      else {
+        tree_emitters.push_back(light_tree_emitter_from_light(scene, light, offset));
+        leaf_map[light_index] = offset;
+      }
+    }
+
     if (light->type == LIGHT_DISTANT) {
       use_lamp_mis |= (light->angle > 0.0f && light->use_mis);
     }
@@ -493,6 +595,51 @@ void LightManager::device_update_distribution(Device *,
     /* CDF */
     dscene->light_distribution.copy_to_device();
 
+    /* Light tree */
+    if (use_light_tree) {
+      if (!tree_emitters.empty()) {
+        LightTree light_tree(tree_emitters);
+        const vector<KernelLightTreeNode> &nodes = light_tree.nodes;
+
+        /* Replace distribution indices in the leaf map with leaf nodes. */
+        vector<int> distribution_leaf(num_distribution, -1);
+        for (size_t i = 0; i < nodes.size(); i++) {
+          if (nodes[i].child < 0) {
+            distribution_leaf[-1 - nodes[i].child] = i;
+          }
+        }
+        const size_t leaf_map_triangles_offset = leaf_map_objects_offset +
+                                                 scene->objects.size() * 2;
+        for (size_t i = 0; i < leaf_map.size(); i++) {
+          const bool is_light = (i < num_lights);
+          const bool is_triangle = (i >= leaf_map_triangles_offset);
+          if ((is_light || is_triangle) && leaf_map[i] != -1) {
+            leaf_map[i] = distribution_leaf[leaf_map[i]];
+          }
+        }
+
+        KernelLightTreeNode *knodes = dscene->light_tree_nodes.alloc(nodes.size());
+        std::copy(nodes.begin(), nodes.end(), knodes);
+        dscene->light_tree_nodes.copy_to_device();
+
+        VLOG(1) << "Light tree with " << nodes.size() << " nodes over " << tree_emitters.size()
+                << " emitters.";
+      }
+      else {
+        /* Only distant and background lights. */
+        dscene->light_tree_nodes.free();
+      }
+
+      int *kleaf_map = dscene->light_tree_leaf_map.alloc(leaf_map.size());
+      std::copy(leaf_map.begin(), leaf_map.end(), kleaf_map);
+      dscene->light_tree_leaf_map.copy_to_device();
+    }
+    else {
+      dscene->light_tree_nodes.free();
+      dscene->light_tree_leaf_map.free();
+    }
+    kintegrator->num_light_tree_infinite = num_infinite_lights;
+
     /* Portals */
     if (num_portals > 0) {
       kbackground->portal_offset = light_index;
@@ -510,8 +657,11 @@ void LightManager::device_update_distribution(Device *,
   }
   else {
     dscene->light_distribution.free();
+    dscene->light_tree_nodes.free();
+    dscene->light_tree_leaf_map.free();
 
     kintegrator->num_distribution = 0;
+    kintegrator->num_light_tree_infinite = 0;
     kintegrator->num_all_lights = 0;
     kintegrator->pdf_triangles = 0.0f;
     kintegrator->pdf_lights = 0.0f;
@@ -1000,6 +1150,8 @@ void LightManager::device_update(Device *device,
 void LightManager::device_free(Device *, DeviceScene *dscene, const bool free_background)
 {
   dscene->light_distribution.free();
+  dscene->light_tree_nodes.free();
+  dscene->light_tree_leaf_map.free();
   dscene->lights.free();
   if (free_background) {
     dscene->light_background_marginal_cdf.free();
@@ -0,0 +1,255 @@
+/*
+ * Copyright 2011-2020 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "render/light_tree.h"
+
+#include "util/util_algorithm.h"
+#include "util/util_math.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Smallest cone containing both cones. */
+static LightTreeCone light_tree_cone_union(const LightTreeCone &a, const LightTreeCone &b)
+{
+  if (b.theta_o > a.theta_o) {
+    return light_tree_cone_union(b, a);
+  }
+
+  const float cos_d = dot(a.axis, b.axis);
+  const float theta_d = safe_acosf(cos_d);
+  const float theta_e = max(a.theta_e, b.theta_e);
+
+  if (min(theta_d + b.theta_o, M_PI_F) <= a.theta_o) {
+    return LightTreeCone(a.axis, a.theta_o, theta_e);
+  }
+
+  const float theta_o = 0.5f * (a.theta_o + theta_d + b.theta_o);
+  const float3 ortho = b.axis - cos_d * a.axis;
+  const float ortho_len = len(ortho);
+  if (theta_o >= M_PI_F || ortho_len < 1e-6f) {
+    return LightTreeCone(a.axis, M_PI_F, theta_e);
+  }
+
+  /* Rotate the axis of the wider cone towards the other one, so the result just covers both. */
+  const float theta_r = theta_o - a.theta_o;
+  const float3 axis = normalize(cosf(theta_r) * a.axis + sinf(theta_r) * (ortho / ortho_len));
+  return LightTreeCone(axis, theta_o, theta_e);
+}
+
+/* Solid angle measure of the directions light can be emitted into, see the paper. */
+static float light_tree_cone_measure(const LightTreeCone &cone)
+{
+  const float theta_w = min(cone.theta_o + cone.theta_e, M_PI_F);
+  const float cos_o = cosf(cone.theta_o);
+  const float sin_o = sinf(cone.theta_o);
+  return M_2PI_F * (1.0f - cos_o) +
+         M_PI_2_F * (2.0f * theta_w * sin_o - cosf(cone.theta_o - 2.0f * theta_w) -
+                     2.0f * cone.theta_o * sin_o + cos_o);
+}
+
+static const int LIGHT_TREE_NUM_BINS = 12;
+
+static int light_tree_bin(const LightTreeEmitter &emitter,
+                          const int axis,
+                          const float bin_min,
+                          const float inv_bin_size)
+{
+  const float centroid = emitter.bounds.center()[axis];
+  return clamp((int)((centroid - bin_min) * inv_bin_size), 0, LIGHT_TREE_NUM_BINS - 1);
+}
+
+/* Combined bounds of a set of emitters. */
+struct LightTreeBounds {
+  BoundBox bbox;
+  LightTreeCone cone;
+  float energy;
+  int num_emitters;
+
+  LightTreeBounds() : bbox(BoundBox::empty), energy(0.0f), num_emitters(0)
+  {
+  }
+
+  void add(const BoundBox &other_bbox,
+           const LightTreeCone &other_cone,
+           float other_energy,
+           int other_num_emitters)
+  {
+    if (other_num_emitters == 0) {
+      return;
+    }
+    cone = (num_emitters == 0) ? other_cone : light_tree_cone_union(cone, other_cone);
+    bbox.grow(other_bbox);
+    energy += other_energy;
+    num_emitters += other_num_emitters;
+  }
+
+  void add(const LightTreeEmitter &emitter)
+  {
+    add(emitter.bounds, emitter.cone, emitter.energy, 1);
+  }
+
+  void add(const LightTreeBounds &other)
+  {
+    add(other.bbox, other.cone, other.energy, other.num_emitters);
+  }
+
+  /* Surface area orientation heuristic. */
+  float cost() const
+  {
+    return energy * bbox.safe_area() * light_tree_cone_measure(cone);
+  }
+};
+
+LightTree::LightTree(vector<LightTreeEmitter> &emitters) : emitters_(emitters)
+{
+  build();
+}
+
+void LightTree::build()
+{
+  nodes.clear();
+
+  if (emitters_.empty()) {
+    return;
+  }
+
+  struct BuildTask {
+    int start, end;
+    int parent;
+    bool is_right_child;
+  };
+
+  nodes.reserve(emitters_.size() * 2 - 1);
+
+  /* Build without recursion, unbalanced trees over many emitters could overflow the stack.
+   * Children are pushed in reverse order so nodes end up depth first. */
+  vector<BuildTask> stack;
+  stack.push_back({0, (int)emitters_.size(), -1, false});
+
+  while (!stack.empty()) {
+    const BuildTask task = stack.back();
+    stack.pop_back();
+
+    const int index = nodes.size();
+    if (task.is_right_child) {
+      nodes[task.parent].child = index;
+    }
+
+    LightTreeBounds bounds;
+    BoundBox centroid_bounds = BoundBox::empty;
+    for (int i = task.start; i < task.end; i++) {
+      bounds.add(emitters_[i]);
+      centroid_bounds.grow(emitters_[i].bounds.center());
+    }
+
+    KernelLightTreeNode knode;
+    knode.bbox_min[0] = bounds.bbox.min.x;
+    knode.bbox_min[1] = bounds.bbox.min.y;
+    knode.bbox_min[2] = bounds.bbox.min.z;
+    knode.energy = bounds.energy;
+    knode.bbox_max[0] = bounds.bbox.max.x;
+    knode.bbox_max[1] = bounds.bbox.max.y;
+    knode.bbox_max[2] = bounds.bbox.max.z;
+    knode.theta_o = bounds.cone.theta_o;
+    knode.axis[0] = bounds.cone.axis.x;
+    knode.axis[1] = bounds.cone.axis.y;
+    knode.axis[2] = bounds.cone.axis.z;
+    knode.theta_e = bounds.cone.theta_e;
+    knode.child = -1;
+    knode.parent = task.parent;
+    knode.pad1 = 0;
+    knode.pad2 = 0;
+
+    if (task.end - task.start == 1) {
+      knode.child = -1 - emitters_[task.start].distribution_index;
+      nodes.push_back(knode);
+      continue;
+    }
+
+    nodes.push_back(knode);
+
+    const int middle = split(task.start, task.end, centroid_bounds);
+    stack.push_back({middle, task.end, index, true});
+    stack.push_back({task.start, middle, index, false});
+  }
+}
+
+/* Find the best split of the emitters with binning along each axis, and partition them
+ * accordingly. Returns the first emitter of the second half. */
+int LightTree::split(int start, int end, const BoundBox &centroid_bounds)
+{
+  const float3 extent = centroid_bounds.size();
+  const float max_extent = max3(extent);
+
+  float best_cost = FLT_MAX;
+  int best_axis = -1;
+  int best_bin = 0;
+
+  for (int axis = 0; axis < 3 && max_extent > 0.0f; axis++) {
+    if (!(extent[axis] > 0.0f)) {
+      continue;
+    }
+
+    const float inv_bin_size = LIGHT_TREE_NUM_BINS / extent[axis];
+    LightTreeBounds bins[LIGHT_TREE_NUM_BINS];
+    for (int i = start; i < end; i++) {
+      bins[light_tree_bin(emitters_[i], axis, centroid_bounds.min[axis], inv_bin_size)].add(
+          emitters_[i]);
+    }
+
+    float right_cost[LIGHT_TREE_NUM_BINS];
+    LightTreeBounds right;
+    for (int bin = LIGHT_TREE_NUM_BINS - 1; bin > 0; bin--) {
+      right.add(bins[bin]);
+      right_cost[bin] = (right.num_emitters != 0) ? right.cost() : FLT_MAX;
+    }
+
+    /* Penalize splitting thin axes, which gives elongated nodes. */
+    const float regularization = max_extent / extent[axis];
+    LightTreeBounds left;
+    for (int bin = 1; bin < LIGHT_TREE_NUM_BINS; bin++) {
+      left.add(bins[bin - 1]);
+      if (left.num_emitters == 0 || right_cost[bin] == FLT_MAX) {
+        continue;
+      }
+      const float cost = (left.cost() + right_cost[bin]) * regularization;
+      if (cost < best_cost) {
+        best_cost = cost;
+        best_axis = axis;
+        best_bin = bin;
+      }
+    }
+  }
+
+  int middle = (start + end) / 2;
+
+  if (best_axis != -1) {
+    const float inv_bin_size = LIGHT_TREE_NUM_BINS / extent[best_axis];
+    const float bin_min = centroid_bounds.min[best_axis];
+    auto split_it = std::partition(
+        emitters_.begin() + start, emitters_.begin() + end, [&](const LightTreeEmitter &emitter) {
+          return light_tree_bin(emitter, best_axis, bin_min, inv_bin_size) < best_bin;
+        });
+    const int split_index = split_it - emitters_.begin();
+    if (split_index > start && split_index < end) {
+      middle = split_index;
+    }
+  }
+
+  return middle;
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2011-2020 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LIGHT_TREE_H__
+#define __LIGHT_TREE_H__
+
+#include "kernel/kernel_types.h"
+
+#include "util/util_boundbox.h"
+#include "util/util_types.h"
+#include "util/util_vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Bounds of the directions an emitter sends light into: its normals are within theta_o of the
+ * axis, and light leaves at most theta_e away from the normal. */
+struct LightTreeCone {
+  float3 axis;
+  float theta_o;
+  float theta_e;
+
+  LightTreeCone() : axis(make_float3(0.0f, 0.0f, 1.0f)), theta_o(0.0f), theta_e(0.0f)
+  {
+  }
+
+  LightTreeCone(const float3 &axis, float theta_o, float theta_e)
+      : axis(axis), theta_o(theta_o), theta_e(theta_e)
+  {
+  }
+
+  /* Emitting equally into all directions. */
+  static LightTreeCone omnidirectional()
+  {
+    return LightTreeCone(make_float3(0.0f, 0.0f, 1.0f), M_PI_F, M_PI_2_F);
+  }
+};
+
+/* Primitive of the light distribution the tree is built over. */
+struct LightTreeEmitter {
+  BoundBox bounds;
+  LightTreeCone cone;
+  /* Rough estimate of the emitted power. */
+  float energy;
+  /* Index of the emitter in the light distribution. */
+  int distribution_index;
+
+  LightTreeEmitter(const BoundBox &bounds,
+                   const LightTreeCone &cone,
+                   float energy,
+                   int distribution_index)
+      : bounds(bounds), cone(cone), energy(energy), distribution_index(distribution_index)
+  {
+  }
+};
+
+/* Bounding volume hierarchy over emitters, used to select lights proportional to their
+ * estimated contribution to a shading point. Based on "Importance Sampling of Many Lights with
+ * Adaptive Tree Splitting" by Alejandro Conty Estevez and Christopher Kulla.
+ *
+ * Every leaf holds a single emitter. The emitters are reordered during the build. */
+class LightTree {
+ public:
+  LightTree(vector<LightTreeEmitter> &emitters);
+
+  vector<KernelLightTreeNode> nodes;
+
+ protected:
+  void build();
+  int split(int start, int end, const BoundBox &centroid_bounds);
+
+  vector<LightTreeEmitter> &emitters_;
+};
+
+CCL_NAMESPACE_END
+
+#endif /* __LIGHT_TREE_H__ */
@@ -248,6 +248,9 @@ NODE_DEFINE(ImageTextureNode)
   SOCKET_FLOAT(projection_blend, "Projection Blend", 0.0f);
 
   SOCKET_IN_POINT(vector, "Vector", make_float3(0.0f, 0.0f, 0.0f), SocketType::LINK_TEXTURE_UV);
+  /* Vector at the neighboring pixels, for mipmap lookups with the texture cache. */
+  SOCKET_IN_POINT(vector_dx, "VectorDX", make_float3(0.0f, 0.0f, 0.0f), SocketType::SVM_INTERNAL);
+  SOCKET_IN_POINT(vector_dy, "VectorDY", make_float3(0.0f, 0.0f, 0.0f), SocketType::SVM_INTERNAL);
 
   SOCKET_OUT_COLOR(color, "Color");
   SOCKET_OUT_FLOAT(alpha, "Alpha");
@@ -376,6 +379,17 @@ void ImageTextureNode::compile(SVMCompiler &compiler)
   int vector_offset = tex_mapping.compile_begin(compiler, vector_in);
   uint flags = 0;
 
+  ShaderInput *vector_dx_in = input("VectorDX");
+  ShaderInput *vector_dy_in = input("VectorDY");
+  const bool use_derivatives = (projection == NODE_IMAGE_PROJ_FLAT && vector_dx_in->link &&
+                                vector_dy_in->link);
+  int vector_dx_offset = SVM_STACK_INVALID;
+  int vector_dy_offset = SVM_STACK_INVALID;
+  if (use_derivatives) {
+    vector_dx_offset = tex_mapping.compile_begin(compiler, vector_dx_in);
+    vector_dy_offset = tex_mapping.compile_begin(compiler, vector_dy_in);
+  }
+
   if (compress_as_srgb) {
     flags |= NODE_IMAGE_COMPRESS_AS_SRGB;
   }
@@ -405,7 +419,7 @@ void ImageTextureNode::compile(SVMCompiler &compiler)
                                              compiler.stack_assign_if_linked(color_out),
                                              compiler.stack_assign_if_linked(alpha_out),
                                              flags),
-                      projection);
+                      compiler.encode_uchar4(projection, vector_dx_offset, vector_dy_offset));
 
     if (num_nodes > 0) {
       for (int i = 0; i < num_nodes; i++) {
@@ -436,6 +450,10 @@ void ImageTextureNode::compile(SVMCompiler &compiler)
   }
 
   tex_mapping.compile_end(compiler, vector_in, vector_offset);
+  if (use_derivatives) {
+    tex_mapping.compile_end(compiler, vector_dx_in, vector_dx_offset);
+    tex_mapping.compile_end(compiler, vector_dy_in, vector_dy_offset);
+  }
 }
 
 void ImageTextureNode::compile(OSLCompiler &compiler)
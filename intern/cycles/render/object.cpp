@@ -830,6 +830,13 @@ void ObjectManager::apply_static_transforms(DeviceScene *dscene, Scene *scene, P
       apply = apply && transform_uniform_scale(object->tfm, scale);
     }
 
+    /* With persistent data all geometry keeps its own BVH between frames of a sequence. Static
+     * geometry reuses it and deforming geometry refits it, so only the object level scene BVH
+     * is rebuilt instead of a scene BVH with all primitives. */
+    if (scene->params.persistent_data) {
+      apply = false;
+    }
+
     if (apply) {
       if (!(motion_blur && object->use_motion())) {
         if (!geom->transform_applied) {
@@ -71,6 +71,8 @@ DeviceScene::DeviceScene(Device *device)
       attributes_float3(device, "__attributes_float3", MEM_GLOBAL),
       attributes_uchar4(device, "__attributes_uchar4", MEM_GLOBAL),
       light_distribution(device, "__light_distribution", MEM_GLOBAL),
+      light_tree_nodes(device, "__light_tree_nodes", MEM_GLOBAL),
+      light_tree_leaf_map(device, "__light_tree_leaf_map", MEM_GLOBAL),
       lights(device, "__lights", MEM_GLOBAL),
       light_background_marginal_cdf(device, "__light_background_marginal_cdf", MEM_GLOBAL),
       light_background_conditional_cdf(device, "__light_background_conditional_cdf", MEM_GLOBAL),
@@ -106,7 +108,7 @@ Scene::Scene(const SceneParams &params_, Device *device)
   geometry_manager = new GeometryManager();
   object_manager = new ObjectManager();
   integrator = new Integrator();
-  image_manager = new ImageManager(device->info);
+  image_manager = new ImageManager(device->info, params.texture_cache);
   particle_system_manager = new ParticleSystemManager();
   bake_manager = new BakeManager();
 
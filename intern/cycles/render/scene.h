@@ -105,6 +105,8 @@ class DeviceScene {
 
   /* lights */
   device_vector<KernelLightDistribution> light_distribution;
+  device_vector<KernelLightTreeNode> light_tree_nodes;
+  device_vector<int> light_tree_leaf_map;
   device_vector<KernelLight> lights;
   device_vector<float2> light_background_marginal_cdf;
   device_vector<float2> light_background_conditional_cdf;
@@ -167,11 +169,15 @@ class SceneParams {
   BVHType bvh_type;
   bool use_bvh_spatial_split;
   bool use_bvh_unaligned_nodes;
+  bool use_bvh_quantized_nodes;
+  /* Rebuild instead of refitting geometry BVHs once their SAH cost grew by this factor. */
+  float bvh_refit_max_cost_ratio;
   int num_bvh_time_steps;
   int hair_subdivisions;
   CurveShapeType hair_shape;
   bool persistent_data;
   int texture_limit;
+  TextureCacheParams texture_cache;
 
   bool background;
 
@@ -182,6 +188,8 @@ class SceneParams {
     bvh_type = BVH_DYNAMIC;
     use_bvh_spatial_split = false;
     use_bvh_unaligned_nodes = true;
+    use_bvh_quantized_nodes = false;
+    bvh_refit_max_cost_ratio = 1.5f;
     num_bvh_time_steps = 0;
     hair_subdivisions = 3;
     hair_shape = CURVE_RIBBON;
@@ -196,9 +204,12 @@ class SceneParams {
              bvh_type == params.bvh_type &&
              use_bvh_spatial_split == params.use_bvh_spatial_split &&
              use_bvh_unaligned_nodes == params.use_bvh_unaligned_nodes &&
+             use_bvh_quantized_nodes == params.use_bvh_quantized_nodes &&
+             bvh_refit_max_cost_ratio == params.bvh_refit_max_cost_ratio &&
              num_bvh_time_steps == params.num_bvh_time_steps &&
              hair_subdivisions == params.hair_subdivisions && hair_shape == params.hair_shape &&
-             persistent_data == params.persistent_data && texture_limit == params.texture_limit);
+             persistent_data == params.persistent_data && texture_limit == params.texture_limit &&
+             texture_cache == params.texture_cache);
   }
 
   int curve_subdivisions()
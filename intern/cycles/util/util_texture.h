@@ -93,6 +93,8 @@ typedef enum ExtensionType {
 typedef struct TextureInfo {
   /* Pointer, offset or texture depending on device. */
   uint64_t data;
+  /* Texture cache file on the CPU, zero if the image is fully loaded in data. */
+  uint64_t cache_handle;
   /* Data Type */
   uint data_type;
   /* Buffer number for OpenCL. */
@@ -0,0 +1,192 @@
+/*
+ * Copyright 2011-2020 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "util/util_texture_cache.h"
+
+#include "util/util_logging.h"
+#include "util/util_md5.h"
+#include "util/util_path.h"
+
+#include <OpenImageIO/imagebufalgo.h>
+#include <OpenImageIO/strutil.h>
+#include <OpenImageIO/texture.h>
+
+CCL_NAMESPACE_BEGIN
+
+OIIO_NAMESPACE_USING
+
+struct TextureCacheFile {
+  TextureSystem *texture_system;
+  TextureSystem::TextureHandle *handle;
+  ustring filepath;
+};
+
+TextureCache::TextureCache(int max_memory_mb, int tile_size) : tile_size(tile_size)
+{
+  TextureSystem *ts = TextureSystem::create(false);
+
+  ts->attribute("max_memory_MB", (float)max_memory_mb);
+  ts->attribute("autotile", tile_size);
+  ts->attribute("automip", 1);
+  ts->attribute("gray_to_rgb", 1);
+
+  texture_system = ts;
+}
+
+TextureCache::~TextureCache()
+{
+  map<string, TextureCacheFile *>::iterator it;
+  for (it = files.begin(); it != files.end(); it++) {
+    delete it->second;
+  }
+
+  TextureSystem::destroy((TextureSystem *)texture_system);
+}
+
+uint64_t TextureCache::open(const string &filepath, bool auto_convert, const string &cache_path)
+{
+  if (filepath.empty()) {
+    return 0;
+  }
+
+  /* Convert outside of the lock, so images are converted in parallel when loaded by threads. */
+  const string lookup_filepath = auto_convert ? convert(filepath, cache_path) : filepath;
+
+  thread_scoped_lock lock(mutex);
+
+  TextureSystem *ts = (TextureSystem *)texture_system;
+
+  /* Reuse the file when the image is reloaded, ImageManager invalidates it before. */
+  TextureCacheFile *&file = files[lookup_filepath];
+  if (file == NULL) {
+    file = new TextureCacheFile();
+    file->texture_system = ts;
+    file->filepath = ustring(lookup_filepath);
+    file->handle = ts->get_texture_handle(file->filepath);
+  }
+
+  int exists = 0;
+  if (file->handle == NULL ||
+      !ts->get_texture_info(file->handle, NULL, 0, ustring("exists"), TypeDesc::INT, &exists) ||
+      !exists) {
+    ts->geterror();
+    return 0;
+  }
+
+  return (uint64_t)file;
+}
+
+void TextureCache::invalidate(uint64_t handle)
+{
+  TextureCacheFile *file = (TextureCacheFile *)handle;
+  file->texture_system->invalidate(file->filepath);
+}
+
+/* Write a tiled and mipmapped copy of the image, so lookups only read the tiles and levels they
+ * need from disk. Returns the file to read from, the original one when conversion fails. */
+string TextureCache::convert(const string &filepath, const string &cache_path)
+{
+  if (Strutil::iends_with(filepath, ".tx")) {
+    return filepath;
+  }
+
+  /* The hash of the full path keeps files unique when images with the same name from different
+   * directories share the cache directory, or only differ in their extension. */
+  const string filename = path_filename(filepath);
+  const string tx_filename = filename.substr(0, filename.rfind('.')) + "_" +
+                             util_md5_string(filepath) + ".tx";
+  const string tx_dirpath = cache_path.empty() ? path_dirname(filepath) : cache_path;
+  const string tx_filepath = path_join(tx_dirpath, tx_filename);
+
+  ImageSpec config;
+  config.tile_width = tile_size;
+  config.tile_height = tile_size;
+  config.tile_depth = 1;
+  /* Don't convert again if the .tx file is newer than the image. */
+  config.attribute("maketx:updatemode", 1);
+
+  if (!cache_path.empty()) {
+    path_create_directories(tx_filepath);
+  }
+
+  if (!ImageBufAlgo::make_texture(ImageBufAlgo::MakeTxTexture, filepath, tx_filepath, config)) {
+    LOG(WARNING) << "Failed to convert " << filepath << " for the texture cache: "
+                 << OIIO::geterror();
+    return filepath;
+  }
+
+  VLOG(1) << "Texture cache uses " << tx_filepath << " for " << filepath;
+  return tx_filepath;
+}
+
+float4 TextureCache::lookup(const TextureInfo &info, float x, float y, float2 dx, float2 dy)
+{
+  const TextureCacheFile *file = (const TextureCacheFile *)info.cache_handle;
+
+  TextureOpt options;
+  switch (info.interpolation) {
+    case INTERPOLATION_CLOSEST:
+      options.interpmode = TextureOpt::InterpClosest;
+      break;
+    case INTERPOLATION_CUBIC:
+      options.interpmode = TextureOpt::InterpBicubic;
+      break;
+    case INTERPOLATION_SMART:
+      options.interpmode = TextureOpt::InterpSmartBicubic;
+      break;
+    default:
+      options.interpmode = TextureOpt::InterpBilinear;
+      break;
+  }
+
+  switch (info.extension) {
+    case EXTENSION_REPEAT:
+      options.swrap = options.twrap = TextureOpt::WrapPeriodic;
+      break;
+    case EXTENSION_EXTEND:
+      options.swrap = options.twrap = TextureOpt::WrapClamp;
+      break;
+    default:
+      options.swrap = options.twrap = TextureOpt::WrapBlack;
+      break;
+  }
+
+  /* Opaque alpha for images without an alpha channel. */
+  options.fill = 1.0f;
+
+  /* Image rows are stored bottom to top in Cycles, the texture system starts at the top. */
+  float result[4];
+  if (!file->texture_system->texture(file->handle,
+                                     NULL,
+                                     options,
+                                     x,
+                                     1.0f - y,
+                                     dx.x,
+                                     -dx.y,
+                                     dy.x,
+                                     -dy.y,
+                                     4,
+                                     result)) {
+    /* Clear the error, it would be reported again on every lookup otherwise. */
+    file->texture_system->geterror();
+    return make_float4(
+        TEX_IMAGE_MISSING_R, TEX_IMAGE_MISSING_G, TEX_IMAGE_MISSING_B, TEX_IMAGE_MISSING_A);
+  }
+
+  return make_float4(result[0], result[1], result[2], result[3]);
+}
+
+CCL_NAMESPACE_END
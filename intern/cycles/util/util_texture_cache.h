@@ -0,0 +1,65 @@
+/*
+ * Copyright 2011-2020 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __UTIL_TEXTURE_CACHE_H__
+#define __UTIL_TEXTURE_CACHE_H__
+
+#include "util/util_map.h"
+#include "util/util_string.h"
+#include "util/util_texture.h"
+#include "util/util_thread.h"
+#include "util/util_types.h"
+
+CCL_NAMESPACE_BEGIN
+
+struct TextureCacheFile;
+
+/* Texture Cache
+ *
+ * Reads image files on demand through the OpenImageIO texture system, one tile of one mipmap
+ * level at a time, while keeping memory usage below a fixed size. Only used on the CPU, where
+ * the kernel can call into the texture system directly. */
+class TextureCache {
+ public:
+  TextureCache(int max_memory_mb, int tile_size);
+  ~TextureCache();
+
+  /* Open an image file for lookups, returns a handle for TextureInfo.cache_handle. Files that
+   * are not tiled and mipmapped yet are optionally converted to .tx files first, written to
+   * cache_path or next to the original file when it is empty. Opening the same file again
+   * returns the same handle. */
+  uint64_t open(const string &filepath, bool auto_convert, const string &cache_path);
+
+  /* Drop cached tiles of the file, so changes on disk are picked up. */
+  void invalidate(uint64_t handle);
+
+  /* Filtered lookup from the kernel, with texture coordinates and their screen space
+   * derivatives in the same convention as kernel_tex_image_interp(). */
+  static float4 lookup(const TextureInfo &info, float x, float y, float2 dx, float2 dy);
+
+ protected:
+  string convert(const string &filepath, const string &cache_path);
+
+  void *texture_system;
+  int tile_size;
+  /* Opened files by the path lookups are done from, owned by the cache. */
+  map<string, TextureCacheFile *> files;
+  thread_mutex mutex;
+};
+
+CCL_NAMESPACE_END
+
+#endif /* __UTIL_TEXTURE_CACHE_H__ */
@@ -2171,6 +2171,8 @@ class USERPREF_PT_experimental_prototypes(ExperimentalPanel, Panel):
         self._draw_items(
             context, (
                 ({"property": "use_new_hair_type"}, "T68981"),
+                ({"property": "use_undo_skip_unchanged_ids"}, None),
+                ({"property": "use_full_frame_compositor"}, None),
             ),
         )
 
@@ -385,6 +385,11 @@ static void setup_app_data(bContext *C,
     /* TODO(sergey): Can this be also move above? */
     RE_FreeAllPersistentData();
   }
+  else {
+    /* Render engines with persistent data keep their depsgraph, which still references the IDs
+     * of the main database that was freed by undo. */
+    RE_FreePersistentData();
+  }
 
   if (mode == LOAD_UNDO) {
     /* In undo/redo case, we do a whole lot of magic tricks to avoid having to re-read linked
@@ -1540,8 +1540,12 @@ void BKE_scene_graph_evaluated_ensure(Depsgraph *depsgraph, Main *bmain)
   scene_graph_update_tagged(depsgraph, bmain, true);
 }
 
-/* applies changes right away, does all sets too */
-void BKE_scene_graph_update_for_newframe(Depsgraph *depsgraph, Main *bmain)
+/* applies changes right away, does all sets too.
+ * When clear_recalc is false, recalc flags are left for the caller to see which IDs changed
+ * and to clear afterwards, as is done for render engines with persistent data. */
+void BKE_scene_graph_update_for_newframe_ex(Depsgraph *depsgraph,
+                                            Main *bmain,
+                                            const bool clear_recalc)
 {
   Scene *scene = DEG_get_input_scene(depsgraph);
   ViewLayer *view_layer = DEG_get_input_view_layer(depsgraph);
@@ -1584,7 +1588,9 @@ void BKE_scene_graph_update_for_newframe(Depsgraph *depsgraph, Main *bmain)
     /* Inform editors about possible changes. */
     DEG_ids_check_recalc(bmain, depsgraph, scene, view_layer, true);
     /* clear recalc flags */
-    DEG_ids_clear_recalc(bmain, depsgraph);
+    if (clear_recalc) {
+      DEG_ids_clear_recalc(bmain, depsgraph);
+    }
 
     /* If user callback did not tag anything for update we can skip second iteration.
      * Otherwise we update scene once again, but without running callbacks to bring
@@ -1595,6 +1601,11 @@ void BKE_scene_graph_update_for_newframe(Depsgraph *depsgraph, Main *bmain)
   }
 }
 
+void BKE_scene_graph_update_for_newframe(Depsgraph *depsgraph, Main *bmain)
+{
+  BKE_scene_graph_update_for_newframe_ex(depsgraph, bmain, true);
+}
+
 /**
  * Ensures given scene/view_layer pair has a valid, up-to-date depsgraph.
  *
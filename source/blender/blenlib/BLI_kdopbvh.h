@@ -232,6 +232,27 @@ void BLI_bvhtree_ray_cast_all(BVHTree *tree,
                               BVHTree_RayCastCallback callback,
                               void *userdata);
 
+/* Batched versions of #BLI_bvhtree_find_nearest_ex and #BLI_bvhtree_ray_cast_ex.
+ * Queries are reordered for coherence and run on multiple threads,
+ * so callbacks must be thread-safe.
+ * `r_nearest` / `r_hit` are in-out arrays initialized like for the single queries. */
+void BLI_bvhtree_find_nearest_batch(BVHTree *tree,
+                                    const float (*co)[3],
+                                    int co_len,
+                                    BVHTreeNearest *r_nearest,
+                                    BVHTree_NearestPointCallback callback,
+                                    void *userdata,
+                                    int flag);
+void BLI_bvhtree_ray_cast_batch(BVHTree *tree,
+                                const float (*co)[3],
+                                const float (*dir)[3],
+                                int rays_len,
+                                float radius,
+                                BVHTreeRayHit *r_hit,
+                                BVHTree_RayCastCallback callback,
+                                void *userdata,
+                                int flag);
+
 float BLI_bvhtree_bb_raycast(const float bv[6],
                              const float light_start[3],
                              const float light_end[3],
@@ -33,6 +33,7 @@ extern "C" {
 #endif
 
 struct BLI_mempool;
+struct MemArena;
 
 /* Task Scheduler
  *
@@ -121,6 +122,11 @@ typedef struct TaskParallelTLS {
    * worker threads. This is similar to OpenMP's firstprivate.
    */
   void *userdata_chunk;
+  /* Arena for temporary allocations, owned by the worker thread so no locking is
+   * needed. Only set when #TaskParallelSettings.use_tls_memarena is enabled.
+   * Allocations stay valid until the parallel range function returns.
+   */
+  struct MemArena *memarena;
 } TaskParallelTLS;
 
 typedef void (*TaskParallelRangeFunc)(void *__restrict userdata,
@@ -140,6 +146,18 @@ typedef struct TaskParallelSettings {
    * is higher than a chunk size. As in, threading will always be performed.
    */
   bool use_threading;
+  /* Give each worker thread a #MemArena in #TaskParallelTLS.memarena, freed once the
+   * whole range has been processed (after `func_reduce` and `func_free`).
+   * Only supported by BLI_task_parallel_range().
+   */
+  bool use_tls_memarena;
+  /* Choose the chunk size from the measured cost of the first iterations, which are run on
+   * the calling thread. Cheap loops are then finished without threading.
+   * Meant for loops of many small iterations with unknown cost, loops with few expensive
+   * iterations lose parallelism while probing. Overrides `min_iter_per_thread`.
+   * Only supported by BLI_task_parallel_range().
+   */
+  bool use_adaptive_grain_size;
   /* Each instance of looping chunks will get a copy of this data
    * (similar to OpenMP's firstprivate).
    */
@@ -0,0 +1,74 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#pragma once
+
+/** \file
+ * \ingroup bli
+ *
+ * C++ task parallel utilities.
+ *
+ * As opposed to #BLI_task_parallel_range, the callback is a template parameter,
+ * so it is inlined into the loop and can capture any state by reference instead of
+ * going through a function pointer and `void *` user-data.
+ *
+ * \note Modules using these functions need `WITH_TBB` to be defined,
+ * otherwise the work is done on the calling thread.
+ */
+
+#ifdef WITH_TBB
+/* Quiet top level deprecation message, unrelated to API usage here. */
+#  define TBB_SUPPRESS_DEPRECATED_MESSAGES 1
+#  include <tbb/tbb.h>
+#endif
+
+#include "BLI_index_range.hh"
+#include "BLI_utildefines.h"
+
+namespace blender {
+
+/**
+ * Call \a function with sub-ranges of \a range, potentially from multiple threads.
+ *
+ * \param grain_size: Sub-ranges are never split below this size,
+ * ranges smaller than this are processed on the calling thread.
+ * Choose it so a sub-range is substantially more work than scheduling it.
+ * \param function: Called as `function(IndexRange sub_range)`.
+ */
+template<typename Function>
+void parallel_for(IndexRange range, int64_t grain_size, const Function &function)
+{
+  if (range.size() == 0) {
+    return;
+  }
+#ifdef WITH_TBB
+  if (range.size() > grain_size) {
+    /* Isolate so a thread waiting on a nested parallel loop doesn't pick up unrelated work,
+     * see #BLI_task_parallel_range. */
+    tbb::this_task_arena::isolate([&] {
+      tbb::parallel_for(
+          tbb::blocked_range<int64_t>(range.first(), range.one_after_last(), grain_size),
+          [&](const tbb::blocked_range<int64_t> &sub_range) { function(IndexRange(sub_range)); });
+    });
+    return;
+  }
+#else
+  UNUSED_VARS(grain_size);
+#endif
+  function(range);
+}
+
+}  // namespace blender
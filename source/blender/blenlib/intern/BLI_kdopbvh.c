@@ -40,6 +40,10 @@
 
 #include <assert.h>
 
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
 #include "MEM_guardedalloc.h"
 
 #include "BLI_alloca.h"
@@ -63,6 +67,9 @@
 
 #define MAX_TREETYPE 32
 
+/* Number of children stored side by side in #BVHWideNode. */
+#define BVH_WIDE_WIDTH 4
+
 /* Setting zero so we can catch bugs in BLI_task/KDOPBVH.
  * TODO(sergey): Deduplicate the limits with PBVH from BKE.
  */
@@ -90,12 +97,31 @@ typedef struct BVHNode {
   char main_axis; /* Axis used to split this node */
 } BVHNode;
 
+/**
+ * Flat copy of a branch node, used by ray-cast and nearest queries on trees
+ * with at most #BVH_WIDE_WIDTH children per node.
+ * The x/y/z bounds of all children are stored next to each other,
+ * so they can be tested at once (with SSE when available).
+ */
+typedef struct BVHWideNode {
+  float bv_min[3][BVH_WIDE_WIDTH]; /* [axis][child] */
+  float bv_max[3][BVH_WIDE_WIDTH];
+  /* Index into #BVHTree.nodewide for branches, `-1 - i` for the leaf `nodearray[i]`. */
+  int child[BVH_WIDE_WIDTH];
+  char totnode;
+  char main_axis;
+  char _pad[14]; /* Two cache lines per node. */
+} BVHWideNode;
+
+BLI_STATIC_ASSERT(sizeof(BVHWideNode) == 128, "unexpected size")
+
 /* keep under 26 bytes for speed purposes */
 struct BVHTree {
   BVHNode **nodes;
   BVHNode *nodearray;  /* pre-alloc branch nodes */
   BVHNode **nodechild; /* pre-alloc children for nodes */
   float *nodebv;       /* pre-alloc bounding-volumes for nodes */
+  BVHWideNode *nodewide; /* branches in wide layout (optional, see #bvhtree_wide_build) */
   float epsilon;       /* epslion is used for inflation of the k-dop      */
   int totleaf;         /* leafs */
   int totbranch;
@@ -105,8 +131,8 @@ struct BVHTree {
 };
 
 /* optimization, ensure we stay small */
-BLI_STATIC_ASSERT((sizeof(void *) == 8 && sizeof(BVHTree) <= 48) ||
-                      (sizeof(void *) == 4 && sizeof(BVHTree) <= 32),
+BLI_STATIC_ASSERT((sizeof(void *) == 8 && sizeof(BVHTree) <= 56) ||
+                      (sizeof(void *) == 4 && sizeof(BVHTree) <= 36),
                   "over sized")
 
 /* avoid duplicating vars in BVHOverlapData_Thread */
@@ -848,6 +874,67 @@ static void non_recursive_bvh_div_nodes(const BVHTree *tree,
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Wide Node Layout
+ *
+ * Branch nodes are copied into a flat #BVHWideNode array in the same order as
+ * `tree->nodes[tree->totleaf..]`, so the root is always `tree->nodewide[0]`.
+ * \{ */
+
+static bool bvhtree_wide_supported(const BVHTree *tree)
+{
+  /* The wide layout only stores the x/y/z bounds. */
+  return (tree->tree_type <= BVH_WIDE_WIDTH) && (tree->start_axis == 0) && (tree->totleaf > 0);
+}
+
+static void bvhtree_wide_update_bounds(BVHTree *tree)
+{
+  for (int i = 0; i < tree->totbranch; i++) {
+    const BVHNode *node = tree->nodes[tree->totleaf + i];
+    BVHWideNode *wnode = &tree->nodewide[i];
+
+    for (int c = 0; c < node->totnode; c++) {
+      const float *bv = node->children[c]->bv;
+      for (int axis = 0; axis < 3; axis++) {
+        wnode->bv_min[axis][c] = bv[2 * axis];
+        wnode->bv_max[axis][c] = bv[2 * axis + 1];
+      }
+    }
+  }
+}
+
+static void bvhtree_wide_build(BVHTree *tree)
+{
+  /* The tree may be balanced again, branches are rebuilt from scratch. */
+  MEM_SAFE_FREE(tree->nodewide);
+  if (!bvhtree_wide_supported(tree)) {
+    return;
+  }
+
+  tree->nodewide = MEM_mallocN_aligned(
+      sizeof(BVHWideNode) * (size_t)tree->totbranch, 64, "BVHWideNode");
+
+  const BVHNode *branch_first = tree->nodes[tree->totleaf];
+  for (int i = 0; i < tree->totbranch; i++) {
+    const BVHNode *node = tree->nodes[tree->totleaf + i];
+    BVHWideNode *wnode = &tree->nodewide[i];
+
+    memset(wnode, 0, sizeof(*wnode));
+    wnode->totnode = node->totnode;
+    wnode->main_axis = node->main_axis;
+
+    for (int c = 0; c < node->totnode; c++) {
+      const BVHNode *child = node->children[c];
+      wnode->child[c] = (child->totnode == 0) ? -1 - (int)(child - tree->nodearray) :
+                                                (int)(child - branch_first);
+    }
+  }
+
+  bvhtree_wide_update_bounds(tree);
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name BLI_bvhtree API
  * \{ */
@@ -934,6 +1021,7 @@ void BLI_bvhtree_free(BVHTree *tree)
     MEM_SAFE_FREE(tree->nodearray);
     MEM_SAFE_FREE(tree->nodebv);
     MEM_SAFE_FREE(tree->nodechild);
+    MEM_SAFE_FREE(tree->nodewide);
     MEM_freeN(tree);
   }
 }
@@ -961,6 +1049,8 @@ void BLI_bvhtree_balance(BVHTree *tree)
   build_skip_links(tree, tree->nodes[tree->totleaf], NULL, NULL);
 #endif
 
+  bvhtree_wide_build(tree);
+
 #ifdef USE_VERIFY_TREE
   bvhtree_verify(tree);
 #endif
@@ -1036,6 +1126,10 @@ void BLI_bvhtree_update_tree(BVHTree *tree)
   for (; index >= root; index--) {
     node_join(tree, *index);
   }
+
+  if (tree->nodewide) {
+    bvhtree_wide_update_bounds(tree);
+  }
 }
 /**
  * Number of times #BLI_bvhtree_insert has been called.
@@ -1511,6 +1605,75 @@ static void dfs_find_nearest_dfs(BVHNearestData *data, BVHNode *node)
   }
 }
 
+/* Same as #calc_nearest_point_squared for child `c` of a wide node. */
+static float wide_nearest_point_squared(const float proj[3],
+                                        const BVHWideNode *wnode,
+                                        const int c,
+                                        float nearest[3])
+{
+  for (int axis = 0; axis < 3; axis++) {
+    nearest[axis] = min_ff(max_ff(proj[axis], wnode->bv_min[axis][c]), wnode->bv_max[axis][c]);
+  }
+  return len_squared_v3v3(proj, nearest);
+}
+
+/* Squared distances from `proj` to the bounds of all children of a wide node. */
+static void wide_nearest_dist_sq(const float proj[3],
+                                 const BVHWideNode *wnode,
+                                 float r_dist_sq[BVH_WIDE_WIDTH])
+{
+#ifdef __SSE2__
+  __m128 dist_sq = _mm_setzero_ps();
+  for (int axis = 0; axis < 3; axis++) {
+    const __m128 co = _mm_set1_ps(proj[axis]);
+    const __m128 nearest = _mm_min_ps(_mm_max_ps(co, _mm_loadu_ps(wnode->bv_min[axis])),
+                                      _mm_loadu_ps(wnode->bv_max[axis]));
+    const __m128 delta = _mm_sub_ps(co, nearest);
+    dist_sq = _mm_add_ps(dist_sq, _mm_mul_ps(delta, delta));
+  }
+  _mm_storeu_ps(r_dist_sq, dist_sq);
+#else
+  float nearest[3];
+  for (int c = 0; c < BVH_WIDE_WIDTH; c++) {
+    r_dist_sq[c] = wide_nearest_point_squared(proj, wnode, c, nearest);
+  }
+#endif
+}
+
+/* Equivalent of #dfs_find_nearest_dfs using the wide layout. */
+static void dfs_find_nearest_wide(BVHNearestData *data, const BVHWideNode *wnode)
+{
+  float dist_sq[BVH_WIDE_WIDTH];
+  wide_nearest_dist_sq(data->proj, wnode, dist_sq);
+
+  /* Better heuristic to pick the closest node to dive on */
+  const bool forward = data->proj[wnode->main_axis] <= wnode->bv_max[wnode->main_axis][0];
+
+  for (int i = 0; i != wnode->totnode; i++) {
+    const int c = forward ? i : wnode->totnode - 1 - i;
+    /* Compare against the current distance, earlier children may have found a closer one. */
+    if (dist_sq[c] >= data->nearest.dist_sq) {
+      continue;
+    }
+
+    const int child = wnode->child[c];
+    if (child >= 0) {
+      dfs_find_nearest_wide(data, &data->tree->nodewide[child]);
+    }
+    else {
+      const BVHNode *leaf = &data->tree->nodearray[-1 - child];
+      if (data->callback) {
+        data->callback(data->userdata, leaf->index, data->co, &data->nearest);
+      }
+      else {
+        data->nearest.index = leaf->index;
+        data->nearest.dist_sq = wide_nearest_point_squared(
+            data->proj, wnode, c, data->nearest.co);
+      }
+    }
+  }
+}
+
 static void dfs_find_nearest_begin(BVHNearestData *data, BVHNode *node)
 {
   float nearest[3], dist_sq;
@@ -1518,7 +1681,13 @@ static void dfs_find_nearest_begin(BVHNearestData *data, BVHNode *node)
   if (dist_sq >= data->nearest.dist_sq) {
     return;
   }
-  dfs_find_nearest_dfs(data, node);
+  if (data->tree->nodewide) {
+    /* The root is the first wide node. */
+    dfs_find_nearest_wide(data, data->tree->nodewide);
+  }
+  else {
+    dfs_find_nearest_dfs(data, node);
+  }
 }
 
 /* Priority queue method */
@@ -1827,6 +1996,85 @@ static void dfs_raycast(BVHRayCastData *data, BVHNode *node)
   }
 }
 
+/**
+ * Same as #fast_ray_nearest_hit for all children of a wide node,
+ * misses are set to #FLT_MAX.
+ */
+static void wide_ray_nearest_hit(const BVHRayCastData *data,
+                                 const BVHWideNode *wnode,
+                                 float r_dist[BVH_WIDE_WIDTH])
+{
+  /* Bounds crossed first and last along the ray, see #bvhtree_ray_cast_data_precalc. */
+  const float *bv_near[3], *bv_far[3];
+  for (int axis = 0; axis < 3; axis++) {
+    const bool flip = (data->index[2 * axis] & 1) != 0;
+    bv_near[axis] = flip ? wnode->bv_max[axis] : wnode->bv_min[axis];
+    bv_far[axis] = flip ? wnode->bv_min[axis] : wnode->bv_max[axis];
+  }
+
+#ifdef __SSE2__
+  __m128 t_near[3], t_far[3];
+  for (int axis = 0; axis < 3; axis++) {
+    const __m128 origin = _mm_set1_ps(data->ray.origin[axis]);
+    const __m128 idot = _mm_set1_ps(data->idot_axis[axis]);
+    t_near[axis] = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(bv_near[axis]), origin), idot);
+    t_far[axis] = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(bv_far[axis]), origin), idot);
+  }
+  const __m128 t_min = _mm_max_ps(t_near[0], _mm_max_ps(t_near[1], t_near[2]));
+  const __m128 t_max = _mm_min_ps(t_far[0], _mm_min_ps(t_far[1], t_far[2]));
+  const __m128 miss = _mm_or_ps(
+      _mm_or_ps(_mm_cmpgt_ps(t_min, t_max), _mm_cmplt_ps(t_max, _mm_setzero_ps())),
+      _mm_cmpgt_ps(t_min, _mm_set1_ps(data->hit.dist)));
+  _mm_storeu_ps(r_dist,
+                _mm_or_ps(_mm_and_ps(miss, _mm_set1_ps(FLT_MAX)), _mm_andnot_ps(miss, t_min)));
+#else
+  for (int c = 0; c < BVH_WIDE_WIDTH; c++) {
+    float t_near[3], t_far[3];
+    for (int axis = 0; axis < 3; axis++) {
+      t_near[axis] = (bv_near[axis][c] - data->ray.origin[axis]) * data->idot_axis[axis];
+      t_far[axis] = (bv_far[axis][c] - data->ray.origin[axis]) * data->idot_axis[axis];
+    }
+    const float t_min = max_fff(t_near[0], t_near[1], t_near[2]);
+    const float t_max = min_fff(t_far[0], t_far[1], t_far[2]);
+    r_dist[c] = (t_min > t_max || t_max < 0.0f || t_min > data->hit.dist) ? FLT_MAX : t_min;
+  }
+#endif
+}
+
+/* Equivalent of #dfs_raycast using the wide layout, only for rays without a radius. */
+static void dfs_raycast_wide(BVHRayCastData *data, const BVHWideNode *wnode)
+{
+  float dist[BVH_WIDE_WIDTH];
+  wide_ray_nearest_hit(data, wnode, dist);
+
+  /* pick loop direction to dive into the tree (based on ray direction and split axis) */
+  const bool forward = data->ray_dot_axis[wnode->main_axis] > 0.0f;
+
+  for (int i = 0; i != wnode->totnode; i++) {
+    const int c = forward ? i : wnode->totnode - 1 - i;
+    /* Compare against the current distance, earlier children may have found a closer hit. */
+    if (dist[c] >= data->hit.dist) {
+      continue;
+    }
+
+    const int child = wnode->child[c];
+    if (child >= 0) {
+      dfs_raycast_wide(data, &data->tree->nodewide[child]);
+    }
+    else {
+      const BVHNode *leaf = &data->tree->nodearray[-1 - child];
+      if (data->callback) {
+        data->callback(data->userdata, leaf->index, &data->ray, &data->hit);
+      }
+      else {
+        data->hit.index = leaf->index;
+        data->hit.dist = dist[c];
+        madd_v3_v3v3fl(data->hit.co, data->ray.origin, data->ray.direction, dist[c]);
+      }
+    }
+  }
+}
+
 /**
  * A version of #dfs_raycast with minor changes to reset the index & dist each ray cast.
  */
@@ -1934,7 +2182,15 @@ int BLI_bvhtree_ray_cast_ex(BVHTree *tree,
   }
 
   if (root) {
-    dfs_raycast(&data, root);
+    if (tree->nodewide && (radius == 0.0f)) {
+      /* The root is the first wide node, its own bounds are tested here. */
+      if (fast_ray_nearest_hit(&data, root) < data.hit.dist) {
+        dfs_raycast_wide(&data, tree->nodewide);
+      }
+    }
+    else {
+      dfs_raycast(&data, root);
+    }
     //      iterative_raycast(&data, root);
   }
 
@@ -2041,6 +2297,227 @@ void BLI_bvhtree_ray_cast_all(BVHTree *tree,
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name BLI_bvhtree_find_nearest_batch / BLI_bvhtree_ray_cast_batch
+ *
+ * Queries are sorted along a Morton curve so consecutive queries visit mostly the same
+ * nodes, which are then still in cache. Chunks of that order are handled by separate threads.
+ * \{ */
+
+/* Number of consecutive (sorted) queries handled by one task. */
+#define BVH_BATCH_CHUNK_SIZE 256
+
+typedef struct BVHBatchOrder {
+  uint code;
+  int index;
+} BVHBatchOrder;
+
+typedef struct BVHBatchData {
+  BVHTree *tree;
+  const BVHBatchOrder *order;
+  int len;
+
+  const float (*co)[3];
+  const float (*dir)[3];
+  float radius;
+  int flag;
+
+  BVHTreeNearest *nearest;
+  BVHTree_NearestPointCallback nearest_callback;
+  BVHTreeRayHit *hit;
+  BVHTree_RayCastCallback raycast_callback;
+  void *userdata;
+} BVHBatchData;
+
+/* Spread the lower 10 bits of `x`, leaving two zero bits between each of them. */
+static uint bvh_morton_spread_bits(uint x)
+{
+  x &= 0x3ff;
+  x = (x | (x << 16)) & 0x030000ff;
+  x = (x | (x << 8)) & 0x0300f00f;
+  x = (x | (x << 4)) & 0x030c30c3;
+  x = (x | (x << 2)) & 0x09249249;
+  return x;
+}
+
+static int bvh_batch_order_cmp(const void *a_v, const void *b_v)
+{
+  const BVHBatchOrder *a = a_v, *b = b_v;
+  if (a->code < b->code) {
+    return -1;
+  }
+  if (a->code > b->code) {
+    return 1;
+  }
+  return (a->index > b->index) - (a->index < b->index);
+}
+
+/**
+ * Sort queries by the Morton code of `co` within its bounds.
+ * When directions are given, rays are first grouped by the octant of their direction,
+ * using 9 bits per axis for the position instead of 10.
+ */
+static BVHBatchOrder *bvh_batch_order_create(const float (*co)[3],
+                                             const float (*dir)[3],
+                                             const int len)
+{
+  BVHBatchOrder *order = MEM_mallocN(sizeof(*order) * (size_t)len, __func__);
+
+  float min[3], max[3], scale[3];
+  INIT_MINMAX(min, max);
+  for (int i = 0; i < len; i++) {
+    minmax_v3v3_v3(min, max, co[i]);
+  }
+
+  const float bits_max = dir ? 511.0f : 1023.0f;
+  for (int axis = 0; axis < 3; axis++) {
+    const float extent = max[axis] - min[axis];
+    scale[axis] = (extent > FLT_EPSILON) ? bits_max / extent : 0.0f;
+  }
+
+  for (int i = 0; i < len; i++) {
+    uint code = 0;
+    for (int axis = 0; axis < 3; axis++) {
+      const uint bits = (uint)((co[i][axis] - min[axis]) * scale[axis]);
+      code |= bvh_morton_spread_bits(bits) << (2 - axis);
+    }
+    if (dir) {
+      const uint octant = (uint)(dir[i][0] < 0.0f) | ((uint)(dir[i][1] < 0.0f) << 1) |
+                          ((uint)(dir[i][2] < 0.0f) << 2);
+      code |= octant << 27;
+    }
+    order[i].code = code;
+    order[i].index = i;
+  }
+
+  qsort(order, (size_t)len, sizeof(*order), bvh_batch_order_cmp);
+  return order;
+}
+
+static void bvhtree_find_nearest_batch_cb(void *__restrict userdata,
+                                          const int chunk,
+                                          const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const BVHBatchData *data = userdata;
+  const int start = chunk * BVH_BATCH_CHUNK_SIZE;
+  const int stop = min_ii(start + BVH_BATCH_CHUNK_SIZE, data->len);
+  int index_prev = -1;
+
+  for (int i = start; i < stop; i++) {
+    const int index = data->order[i].index;
+    BVHTreeNearest *nearest = &data->nearest[index];
+
+    /* The result of the previous (nearby) query is likely close as well, testing it first
+     * gives a tight bound that prunes most of the tree. This needs the callback,
+     * since the distance to the element itself isn't known otherwise. */
+    if (data->nearest_callback && (index_prev != -1)) {
+      data->nearest_callback(data->userdata, index_prev, data->co[index], nearest);
+    }
+
+    BLI_bvhtree_find_nearest_ex(data->tree,
+                                data->co[index],
+                                nearest,
+                                data->nearest_callback,
+                                data->userdata,
+                                data->flag);
+    index_prev = nearest->index;
+  }
+}
+
+static void bvhtree_ray_cast_batch_cb(void *__restrict userdata,
+                                      const int chunk,
+                                      const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const BVHBatchData *data = userdata;
+  const int start = chunk * BVH_BATCH_CHUNK_SIZE;
+  const int stop = min_ii(start + BVH_BATCH_CHUNK_SIZE, data->len);
+
+  for (int i = start; i < stop; i++) {
+    const int index = data->order[i].index;
+    BLI_bvhtree_ray_cast_ex(data->tree,
+                            data->co[index],
+                            data->dir[index],
+                            data->radius,
+                            &data->hit[index],
+                            data->raycast_callback,
+                            data->userdata,
+                            data->flag);
+  }
+}
+
+static void bvhtree_batch_run(BVHBatchData *data, TaskParallelRangeFunc func)
+{
+  const int chunks_len = (data->len + BVH_BATCH_CHUNK_SIZE - 1) / BVH_BATCH_CHUNK_SIZE;
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (data->len > KDOPBVH_THREAD_LEAF_THRESHOLD);
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0, chunks_len, data, func, &settings);
+}
+
+void BLI_bvhtree_find_nearest_batch(BVHTree *tree,
+                                    const float (*co)[3],
+                                    int co_len,
+                                    BVHTreeNearest *r_nearest,
+                                    BVHTree_NearestPointCallback callback,
+                                    void *userdata,
+                                    int flag)
+{
+  if (co_len <= 0) {
+    return;
+  }
+
+  BVHBatchData data = {
+      .tree = tree,
+      .order = bvh_batch_order_create(co, NULL, co_len),
+      .len = co_len,
+      .co = co,
+      .flag = flag,
+      .nearest = r_nearest,
+      .nearest_callback = callback,
+      .userdata = userdata,
+  };
+
+  bvhtree_batch_run(&data, bvhtree_find_nearest_batch_cb);
+
+  MEM_freeN((void *)data.order);
+}
+
+void BLI_bvhtree_ray_cast_batch(BVHTree *tree,
+                                const float (*co)[3],
+                                const float (*dir)[3],
+                                int rays_len,
+                                float radius,
+                                BVHTreeRayHit *r_hit,
+                                BVHTree_RayCastCallback callback,
+                                void *userdata,
+                                int flag)
+{
+  if (rays_len <= 0) {
+    return;
+  }
+
+  BVHBatchData data = {
+      .tree = tree,
+      .order = bvh_batch_order_create(co, dir, rays_len),
+      .len = rays_len,
+      .co = co,
+      .dir = dir,
+      .radius = radius,
+      .flag = flag,
+      .hit = r_hit,
+      .raycast_callback = callback,
+      .userdata = userdata,
+  };
+
+  bvhtree_batch_run(&data, bvhtree_ray_cast_batch_cb);
+
+  MEM_freeN((void *)data.order);
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name BLI_bvhtree_range_query
  *
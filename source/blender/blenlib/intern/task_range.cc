@@ -26,6 +26,7 @@
 
 #include "DNA_listBase.h"
 
+#include "BLI_memarena.h"
 #include "BLI_task.h"
 #include "BLI_threads.h"
 
@@ -35,35 +36,76 @@
 /* Quiet top level deprecation message, unrelated to API usage here. */
 #  define TBB_SUPPRESS_DEPRECATED_MESSAGES 1
 #  include <tbb/tbb.h>
+
+#  include <algorithm>
+#  include <chrono>
 #endif
 
 #ifdef WITH_TBB
 
+/* Per-thread arenas for #TaskParallelTLS.memarena, created on first use by each thread
+ * and freed together once the range is done. */
+struct RangeMemArenas {
+  tbb::enumerable_thread_specific<MemArena *> memarenas;
+
+  RangeMemArenas() : memarenas(nullptr)
+  {
+  }
+
+  ~RangeMemArenas()
+  {
+    for (MemArena *memarena : memarenas) {
+      if (memarena != NULL) {
+        BLI_memarena_free(memarena);
+      }
+    }
+  }
+
+  MemArena *local()
+  {
+    MemArena *&memarena = memarenas.local();
+    if (memarena == NULL) {
+      memarena = BLI_memarena_new(BLI_MEMARENA_STD_BUFSIZE, "RangeTask");
+    }
+    return memarena;
+  }
+};
+
 /* Functor for running TBB parallel_for and parallel_reduce. */
 struct RangeTask {
   TaskParallelRangeFunc func;
   void *userdata;
   const TaskParallelSettings *settings;
+  RangeMemArenas *memarenas;
 
   void *userdata_chunk;
 
   /* Root constructor. */
-  RangeTask(TaskParallelRangeFunc func, void *userdata, const TaskParallelSettings *settings)
-      : func(func), userdata(userdata), settings(settings)
+  RangeTask(TaskParallelRangeFunc func,
+            void *userdata,
+            const TaskParallelSettings *settings,
+            RangeMemArenas *memarenas)
+      : func(func), userdata(userdata), settings(settings), memarenas(memarenas)
   {
     init_chunk(settings->userdata_chunk);
   }
 
   /* Copy constructor. */
   RangeTask(const RangeTask &other)
-      : func(other.func), userdata(other.userdata), settings(other.settings)
+      : func(other.func),
+        userdata(other.userdata),
+        settings(other.settings),
+        memarenas(other.memarenas)
   {
     init_chunk(settings->userdata_chunk);
   }
 
   /* Splitting constructor for parallel reduce. */
   RangeTask(RangeTask &other, tbb::split /* unused */)
-      : func(other.func), userdata(other.userdata), settings(other.settings)
+      : func(other.func),
+        userdata(other.userdata),
+        settings(other.settings),
+        memarenas(other.memarenas)
   {
     init_chunk(settings->userdata_chunk);
   }
@@ -92,6 +134,7 @@ struct RangeTask {
     tbb::this_task_arena::isolate([this, r] {
       TaskParallelTLS tls;
       tls.userdata_chunk = userdata_chunk;
+      tls.memarena = (memarenas != NULL) ? memarenas->local() : NULL;
       for (int i = r.begin(); i != r.end(); ++i) {
         func(userdata, i, &tls);
       }
@@ -104,6 +147,45 @@ struct RangeTask {
   }
 };
 
+/* Adaptive grain size, used when `use_adaptive_grain_size` is set.
+ *
+ * The first iterations are run on the calling thread in doubling batches until
+ * #RANGE_PROBE_NS have passed, which gives an estimate of the cost of one iteration.
+ * Cheap remainders are finished on the calling thread, others are split in chunks
+ * of about #RANGE_CHUNK_NS of work, which is large enough to hide the scheduling
+ * overhead while leaving TBB enough chunks to balance load by work stealing. */
+#  define RANGE_PROBE_NS 20000.0
+#  define RANGE_CHUNK_NS 20000.0
+#  define RANGE_PARALLEL_MIN_NS 50000.0
+
+/* Run iterations from `start` on the calling thread, returns the first iteration not run. */
+static int parallel_range_probe(const RangeTask &task,
+                                const int start,
+                                const int stop,
+                                double *r_ns_per_iter)
+{
+  using Clock = std::chrono::steady_clock;
+  const Clock::time_point time_start = Clock::now();
+  double elapsed_ns = 0.0;
+  int64_t batch = 1;
+  int i = start;
+
+  while (i < stop) {
+    const int batch_stop = (int)std::min<int64_t>((int64_t)i + batch, stop);
+    task(tbb::blocked_range<int>(i, batch_stop));
+    i = batch_stop;
+
+    elapsed_ns = std::chrono::duration<double, std::nano>(Clock::now() - time_start).count();
+    if (elapsed_ns >= RANGE_PROBE_NS) {
+      break;
+    }
+    batch *= 2;
+  }
+
+  *r_ns_per_iter = elapsed_ns / std::max(i - start, 1);
+  return i;
+}
+
 #endif
 
 void BLI_task_parallel_range(const int start,
@@ -114,10 +196,38 @@ void BLI_task_parallel_range(const int start,
 {
 #ifdef WITH_TBB
   /* Multithreading. */
-  if (settings->use_threading && BLI_task_scheduler_num_threads() > 1) {
-    RangeTask task(func, userdata, settings);
-    const size_t grainsize = MAX2(settings->min_iter_per_thread, 1);
-    const tbb::blocked_range<int> range(start, stop, grainsize);
+  const int num_threads = BLI_task_scheduler_num_threads();
+  if (settings->use_threading && num_threads > 1) {
+    /* Declared before the task so the arenas outlive `func_free` calls from its destructor. */
+    RangeMemArenas memarenas;
+    RangeTask task(func, userdata, settings, settings->use_tls_memarena ? &memarenas : NULL);
+    int range_start = start;
+    size_t grainsize = MAX2(settings->min_iter_per_thread, 1);
+
+    if (settings->use_adaptive_grain_size) {
+      /* Iterations done by the probe are accumulated into the root task's chunk,
+       * which is also where the reduction of the parallel part ends up. */
+      double ns_per_iter;
+      range_start = parallel_range_probe(task, start, stop, &ns_per_iter);
+
+      const int remaining = stop - range_start;
+      if (ns_per_iter * remaining < RANGE_PARALLEL_MIN_NS) {
+        if (remaining > 0) {
+          task(tbb::blocked_range<int>(range_start, stop));
+        }
+        if (settings->userdata_chunk) {
+          memcpy(settings->userdata_chunk, task.userdata_chunk, settings->userdata_chunk_size);
+        }
+        return;
+      }
+
+      /* Keep at least one chunk per thread, even when iterations are expensive. */
+      const double chunk_iters = std::min(RANGE_CHUNK_NS / ns_per_iter,
+                                          (double)(remaining / num_threads));
+      grainsize = (size_t)std::max(chunk_iters, 1.0);
+    }
+
+    const tbb::blocked_range<int> range(range_start, stop, grainsize);
 
     if (settings->func_reduce) {
       parallel_reduce(range, task);
@@ -136,12 +246,17 @@ void BLI_task_parallel_range(const int start,
    * main userdata chunk directly. */
   TaskParallelTLS tls;
   tls.userdata_chunk = settings->userdata_chunk;
+  tls.memarena = settings->use_tls_memarena ? BLI_memarena_new(BLI_MEMARENA_STD_BUFSIZE, __func__) :
+                                              NULL;
   for (int i = start; i < stop; i++) {
     func(userdata, i, &tls);
   }
   if (settings->func_free != NULL) {
     settings->func_free(userdata, settings->userdata_chunk);
   }
+  if (tls.memarena != NULL) {
+    BLI_memarena_free(tls.memarena);
+  }
 }
 
 int BLI_task_parallel_thread_id(const TaskParallelTLS *UNUSED(tls))
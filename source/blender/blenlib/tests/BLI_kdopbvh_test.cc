@@ -132,3 +132,142 @@ TEST(kdopbvh, OptimalFindNearest_500)
 {
   find_nearest_points_test(500, 1.0, 1000, 12, true);
 }
+
+/* Trees with up to 4 children per node use a wide node layout for ray-cast and nearest queries,
+ * compare them against a tree with 8 children per node, which doesn't. */
+static BVHTree *bvhtree_from_points(const float (*points)[3], int points_len, int tree_type)
+{
+  BVHTree *tree = BLI_bvhtree_new(points_len, 0.01f, tree_type, 6);
+  for (int i = 0; i < points_len; i++) {
+    BLI_bvhtree_insert(tree, i, points[i], 1);
+  }
+  BLI_bvhtree_balance(tree);
+  return tree;
+}
+
+static void wide_layout_test(int points_len, int tree_type, int random_seed)
+{
+  struct RNG *rng = BLI_rng_new(random_seed);
+  void *mem = MEM_mallocN(sizeof(float[3]) * points_len, __func__);
+  float(*points)[3] = (float(*)[3])mem;
+  rng_v3_round(&points[0][0], points_len * 3, rng, 1000, 1.0f);
+
+  BVHTree *tree_wide = bvhtree_from_points(points, points_len, tree_type);
+  BVHTree *tree_ref = bvhtree_from_points(points, points_len, 8);
+
+  for (int i = 0; i < 100; i++) {
+    float co[3], dir[3];
+    rng_v3_round(co, 3, rng, 1000, 2.0f);
+    BLI_rng_get_float_unit_v3(rng, dir);
+
+    BVHTreeNearest nearest_wide = {-1}, nearest_ref = {-1};
+    nearest_wide.dist_sq = nearest_ref.dist_sq = FLT_MAX;
+    BLI_bvhtree_find_nearest(tree_wide, co, &nearest_wide, NULL, NULL);
+    BLI_bvhtree_find_nearest(tree_ref, co, &nearest_ref, NULL, NULL);
+    EXPECT_GE(nearest_wide.index, 0);
+    EXPECT_FLOAT_EQ(nearest_wide.dist_sq, nearest_ref.dist_sq);
+
+    BVHTreeRayHit hit_wide = {-1}, hit_ref = {-1};
+    hit_wide.dist = hit_ref.dist = BVH_RAYCAST_DIST_MAX;
+    BLI_bvhtree_ray_cast(tree_wide, co, dir, 0.0f, &hit_wide, NULL, NULL);
+    BLI_bvhtree_ray_cast(tree_ref, co, dir, 0.0f, &hit_ref, NULL, NULL);
+    EXPECT_EQ(hit_wide.index == -1, hit_ref.index == -1);
+    EXPECT_FLOAT_EQ(hit_wide.dist, hit_ref.dist);
+  }
+
+  /* Moving the points must update the wide layout too. */
+  for (int i = 0; i < points_len; i++) {
+    add_v3_fl(points[i], 10.0f);
+    BLI_bvhtree_update_node(tree_wide, i, points[i], NULL, 1);
+  }
+  BLI_bvhtree_update_tree(tree_wide);
+  for (int i = 0; i < points_len; i++) {
+    BVHTreeNearest nearest = {-1};
+    nearest.dist_sq = FLT_MAX;
+    BLI_bvhtree_find_nearest(tree_wide, points[i], &nearest, NULL, NULL);
+    EXPECT_FLOAT_EQ(nearest.dist_sq, 0.0f);
+  }
+
+  BLI_bvhtree_free(tree_wide);
+  BLI_bvhtree_free(tree_ref);
+  BLI_rng_free(rng);
+  MEM_freeN(points);
+}
+
+TEST(kdopbvh, WideLayout_Binary)
+{
+  wide_layout_test(500, 2, 12);
+}
+TEST(kdopbvh, WideLayout_Quad)
+{
+  wide_layout_test(500, 4, 123);
+}
+TEST(kdopbvh, WideLayout_Single)
+{
+  wide_layout_test(1, 4, 1234);
+}
+
+static void batch_nearest_point_callback(void *userdata,
+                                         int index,
+                                         const float co[3],
+                                         BVHTreeNearest *nearest)
+{
+  float(*points)[3] = (float(*)[3])userdata;
+  const float dist_sq = len_squared_v3v3(co, points[index]);
+  if (dist_sq < nearest->dist_sq) {
+    nearest->index = index;
+    nearest->dist_sq = dist_sq;
+    copy_v3_v3(nearest->co, points[index]);
+  }
+}
+
+TEST(kdopbvh, Batch)
+{
+  const int points_len = 500, queries_len = 2000;
+  struct RNG *rng = BLI_rng_new(1234);
+
+  float(*points)[3] = (float(*)[3])MEM_mallocN(sizeof(float[3]) * points_len, __func__);
+  float(*co)[3] = (float(*)[3])MEM_mallocN(sizeof(float[3]) * queries_len, __func__);
+  float(*dir)[3] = (float(*)[3])MEM_mallocN(sizeof(float[3]) * queries_len, __func__);
+  rng_v3_round(&points[0][0], points_len * 3, rng, 1000, 1.0f);
+  rng_v3_round(&co[0][0], queries_len * 3, rng, 1000, 2.0f);
+  for (int i = 0; i < queries_len; i++) {
+    BLI_rng_get_float_unit_v3(rng, dir[i]);
+  }
+  BVHTree *tree = bvhtree_from_points(points, points_len, 4);
+
+  BVHTreeNearest *nearest = (BVHTreeNearest *)MEM_mallocN(sizeof(*nearest) * queries_len,
+                                                          __func__);
+  BVHTreeRayHit *hit = (BVHTreeRayHit *)MEM_mallocN(sizeof(*hit) * queries_len, __func__);
+  for (int i = 0; i < queries_len; i++) {
+    nearest[i].index = -1;
+    nearest[i].dist_sq = FLT_MAX;
+    hit[i].index = -1;
+    hit[i].dist = BVH_RAYCAST_DIST_MAX;
+  }
+
+  BLI_bvhtree_find_nearest_batch(
+      tree, co, queries_len, nearest, batch_nearest_point_callback, points, 0);
+  BLI_bvhtree_ray_cast_batch(tree, co, dir, queries_len, 0.0f, hit, NULL, NULL, 0);
+
+  for (int i = 0; i < queries_len; i++) {
+    BVHTreeNearest nearest_single = {-1};
+    nearest_single.dist_sq = FLT_MAX;
+    BLI_bvhtree_find_nearest(tree, co[i], &nearest_single, batch_nearest_point_callback, points);
+    EXPECT_FLOAT_EQ(nearest[i].dist_sq, nearest_single.dist_sq);
+
+    BVHTreeRayHit hit_single = {-1};
+    hit_single.dist = BVH_RAYCAST_DIST_MAX;
+    BLI_bvhtree_ray_cast(tree, co[i], dir[i], 0.0f, &hit_single, NULL, NULL);
+    EXPECT_EQ(hit[i].index, hit_single.index);
+    EXPECT_FLOAT_EQ(hit[i].dist, hit_single.dist);
+  }
+
+  BLI_bvhtree_free(tree);
+  BLI_rng_free(rng);
+  MEM_freeN(points);
+  MEM_freeN(co);
+  MEM_freeN(dir);
+  MEM_freeN(nearest);
+  MEM_freeN(hit);
+}
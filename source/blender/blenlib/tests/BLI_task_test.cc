@@ -9,9 +9,12 @@
 
 #include "BLI_utildefines.h"
 
+#include "BLI_array.hh"
 #include "BLI_listbase.h"
+#include "BLI_memarena.h"
 #include "BLI_mempool.h"
 #include "BLI_task.h"
+#include "BLI_task.hh"
 
 #define NUM_ITEMS 10000
 
@@ -65,6 +68,103 @@ TEST(task, RangeIter)
   BLI_threadapi_exit();
 }
 
+TEST(task, RangeIterAdaptive)
+{
+  int data[NUM_ITEMS] = {0};
+  int sum = 0;
+
+  BLI_threadapi_init();
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_adaptive_grain_size = true;
+
+  settings.userdata_chunk = &sum;
+  settings.userdata_chunk_size = sizeof(sum);
+  settings.func_reduce = task_range_iter_reduce_func;
+
+  BLI_task_parallel_range(0, NUM_ITEMS, data, task_range_iter_func, &settings);
+
+  int expected_sum = 0;
+  for (int i = 0; i < NUM_ITEMS; i++) {
+    EXPECT_EQ(data[i], i);
+    expected_sum += i;
+  }
+  EXPECT_EQ(sum, expected_sum);
+
+  BLI_threadapi_exit();
+}
+
+static void task_range_memarena_func(void *userdata,
+                                     int index,
+                                     const TaskParallelTLS *__restrict tls)
+{
+  int *data = (int *)userdata;
+  EXPECT_TRUE(tls->memarena != NULL);
+  int *buffer = (int *)BLI_memarena_alloc(tls->memarena, sizeof(int) * 4);
+  for (int i = 0; i < 4; i++) {
+    buffer[i] = index;
+  }
+  data[index] = buffer[0] + buffer[1] + buffer[2] + buffer[3];
+}
+
+TEST(task, RangeIterMemArena)
+{
+  int data[NUM_ITEMS] = {0};
+
+  BLI_threadapi_init();
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+  settings.use_tls_memarena = true;
+
+  BLI_task_parallel_range(0, NUM_ITEMS, data, task_range_memarena_func, &settings);
+
+  for (int i = 0; i < NUM_ITEMS; i++) {
+    EXPECT_EQ(data[i], i * 4);
+  }
+
+  BLI_threadapi_exit();
+}
+
+/* *** C++ parallel for. *** */
+
+TEST(task, ParallelFor)
+{
+  BLI_threadapi_init();
+
+  blender::Array<int> data(NUM_ITEMS, 0);
+  int num_calls = 0;
+
+  blender::parallel_for(data.index_range(), 64, [&](const blender::IndexRange range) {
+    for (const int64_t i : range) {
+      data[i] += i;
+    }
+    atomic_add_and_fetch_int32(&num_calls, 1);
+  });
+
+  for (int i = 0; i < NUM_ITEMS; i++) {
+    EXPECT_EQ(data[i], i);
+  }
+  EXPECT_GE(num_calls, 1);
+
+  /* Ranges not larger than the grain size are handled in one call. */
+  num_calls = 0;
+  blender::parallel_for(blender::IndexRange(10, 64), 64, [&](const blender::IndexRange range) {
+    EXPECT_EQ(range, blender::IndexRange(10, 64));
+    num_calls++;
+  });
+  EXPECT_EQ(num_calls, 1);
+
+  blender::parallel_for(blender::IndexRange(), 64, [&](const blender::IndexRange UNUSED(range)) {
+    num_calls++;
+  });
+  EXPECT_EQ(num_calls, 1);
+
+  BLI_threadapi_exit();
+}
+
 /* *** Parallel iterations over mempool items. *** */
 
 static void task_mempool_iter_func(void *userdata, MempoolIterData *item)
@@ -73,6 +73,8 @@ void BLO_memfile_write_init(MemFileWriteData *mem_data,
 void BLO_memfile_write_finalize(MemFileWriteData *mem_data);
 
 void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, unsigned int size);
+bool BLO_memfile_chunk_add_from_reference(MemFileWriteData *mem_data,
+                                          unsigned int id_session_uuid);
 
 /* exports */
 extern void BLO_memfile_free(MemFile *memfile);
@@ -107,6 +107,8 @@
 #include "BLI_math.h"
 #include "BLI_memarena.h"
 #include "BLI_mempool.h"
+#include "BLI_mmap.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 
 #include "BLT_translation.h"
@@ -280,9 +282,14 @@ typedef struct BHeadN {
 
 #define BHEADN_FROM_BHEAD(bh) ((BHeadN *)POINTER_OFFSET(bh, -offsetof(BHeadN, bhead)))
 
-/* We could change this in the future, for now it's simplest if only data is delayed
- * because ID names are used in lookup tables. */
-#define BHEAD_USE_READ_ON_DEMAND(bhead) ((bhead)->code == DATA)
+/* Data is always delayed. ID blocks are only delayed for memory-mapped files,
+ * since ID names are used in lookup tables they are then read from the mapped memory,
+ * see #blo_bhead_id_name. This way linking a few IDs from a large library
+ * only reads the IDs (and data) that are actually used. */
+#define BHEAD_USE_READ_ON_DEMAND(fd, bhead) \
+  ((bhead)->code == DATA || \
+   ((fd)->mmap_file != NULL && ((bhead)->code & ~0xFFFF) == 0 && \
+    BKE_idtype_idcode_is_valid((short)(bhead)->code)))
 
 /**
  * This function ensures that reports are printed,
@@ -400,19 +407,50 @@ static void oldnewmap_clear_map(OldNewMap *onm)
   memset(onm->map, 0xFF, MAP_CAPACITY(onm) * sizeof(*onm->map));
 }
 
-static void oldnewmap_increase_size(OldNewMap *onm)
+static void oldnewmap_resize(OldNewMap *onm, int capacity_exp)
 {
-  onm->capacity_exp++;
-  onm->entries = MEM_reallocN(onm->entries, sizeof(*onm->entries) * ENTRIES_CAPACITY(onm));
-  onm->map = MEM_reallocN(onm->map, sizeof(*onm->map) * MAP_CAPACITY(onm));
+  onm->capacity_exp = capacity_exp;
+  if (onm->nentries == 0) {
+    /* Nothing to copy (common after #oldnewmap_clear). */
+    MEM_freeN(onm->entries);
+    onm->entries = MEM_malloc_arrayN(
+        ENTRIES_CAPACITY(onm), sizeof(*onm->entries), "OldNewMap.entries");
+  }
+  else {
+    onm->entries = MEM_reallocN(onm->entries, sizeof(*onm->entries) * ENTRIES_CAPACITY(onm));
+  }
+  /* The map is rebuilt from the entries, there is no need to copy it. */
+  MEM_freeN(onm->map);
+  onm->map = MEM_malloc_arrayN(MAP_CAPACITY(onm), sizeof(*onm->map), "OldNewMap.map");
   oldnewmap_clear_map(onm);
   for (int i = 0; i < onm->nentries; i++) {
     oldnewmap_insert_index_in_map(onm, onm->entries[i].oldp, i);
   }
 }
 
+static void oldnewmap_increase_size(OldNewMap *onm)
+{
+  oldnewmap_resize(onm, onm->capacity_exp + 1);
+}
+
 /* Public OldNewMap API */
 
+/**
+ * Make room for at least \a count entries up-front,
+ * so the map doesn't have to be grown (and re-hashed) many times while inserting.
+ */
+static void oldnewmap_reserve(OldNewMap *onm, int count)
+{
+  if (count <= ENTRIES_CAPACITY(onm)) {
+    return;
+  }
+  int capacity_exp = onm->capacity_exp;
+  while ((1ll << capacity_exp) < count) {
+    capacity_exp++;
+  }
+  oldnewmap_resize(onm, capacity_exp);
+}
+
 static OldNewMap *oldnewmap_new(void)
 {
   OldNewMap *onm = MEM_callocN(sizeof(*onm), "OldNewMap");
@@ -879,7 +917,7 @@ static BHeadN *get_bhead(FileData *fd)
         /* pass */
       }
 #ifdef USE_BHEAD_READ_ON_DEMAND
-      else if (fd->seek != NULL && BHEAD_USE_READ_ON_DEMAND(&bhead)) {
+      else if (fd->seek != NULL && BHEAD_USE_READ_ON_DEMAND(fd, &bhead)) {
         /* Delay reading bhead content. */
         new_bhead = MEM_mallocN(sizeof(BHeadN), "new_bhead");
         if (new_bhead) {
@@ -1013,6 +1051,24 @@ static bool blo_bhead_read_data(FileData *fd, BHead *thisblock, void *buf)
   return success;
 }
 
+/**
+ * When the file is memory-mapped, return the block data in-place (without reading it).
+ * Useful when the data is only read once, e.g. by #DNA_struct_reconstruct,
+ * so there is no need for an intermediate copy.
+ *
+ * \note Callers must check #BLI_mmap_any_io_error once they're done reading.
+ */
+static const void *blo_bhead_data_mapped(FileData *fd, BHead *thisblock)
+{
+  BHeadN *new_bhead = BHEADN_FROM_BHEAD(thisblock);
+  BLI_assert(new_bhead->has_data == false && new_bhead->file_offset != 0);
+  if (fd->mmap_file == NULL || BLI_mmap_any_io_error(fd->mmap_file) ||
+      (size_t)(new_bhead->file_offset + new_bhead->bhead.len) > fd->buffersize) {
+    return NULL;
+  }
+  return POINTER_OFFSET(BLI_mmap_get_pointer(fd->mmap_file), new_bhead->file_offset);
+}
+
 static BHead *blo_bhead_read_full(FileData *fd, BHead *thisblock)
 {
   BHeadN *new_bhead = BHEADN_FROM_BHEAD(thisblock);
@@ -1032,6 +1088,16 @@ static BHead *blo_bhead_read_full(FileData *fd, BHead *thisblock)
 /* Warning! Caller's responsibility to ensure given bhead **is** and ID one! */
 const char *blo_bhead_id_name(const FileData *fd, const BHead *bhead)
 {
+#ifdef USE_BHEAD_READ_ON_DEMAND
+  const BHeadN *new_bhead = BHEADN_FROM_BHEAD(bhead);
+  if (new_bhead->has_data == false) {
+    /* ID blocks are only read on demand from memory-mapped files,
+     * read the name in-place, see #BHEAD_USE_READ_ON_DEMAND. */
+    BLI_assert(fd->mmap_file != NULL);
+    return (const char *)POINTER_OFFSET(BLI_mmap_get_pointer(fd->mmap_file),
+                                        new_bhead->file_offset + fd->id_name_offs);
+  }
+#endif
   return (const char *)POINTER_OFFSET(bhead, sizeof(*bhead) + fd->id_name_offs);
 }
 
@@ -1222,7 +1288,7 @@ static int fd_read_from_memory(FileData *filedata,
                                bool *UNUSED(r_is_memchunck_identical))
 {
   /* don't read more bytes then there are available in the buffer */
-  int readsize = (int)MIN2(size, (uint)(filedata->buffersize - filedata->file_offset));
+  int readsize = (int)MIN2(size, (size_t)(filedata->buffersize - filedata->file_offset));
 
   memcpy(buffer, filedata->buffer + filedata->file_offset, readsize);
   filedata->file_offset += readsize;
@@ -1230,6 +1296,51 @@ static int fd_read_from_memory(FileData *filedata,
   return readsize;
 }
 
+/* Memory-mapped file reading.
+ * By using mmap(), it is possible to read only the data that is needed,
+ * without going through the kernel's read() copy for every block. */
+
+static int fd_read_from_mmap(FileData *filedata,
+                             void *buffer,
+                             uint size,
+                             bool *UNUSED(r_is_memchunck_identical))
+{
+  /* Don't read more bytes than there are available in the buffer. */
+  size_t readsize = MIN2(size, (size_t)(filedata->buffersize - filedata->file_offset));
+
+  if (!BLI_mmap_read(filedata->mmap_file, buffer, filedata->file_offset, readsize)) {
+    return 0;
+  }
+
+  filedata->file_offset += readsize;
+
+  return (int)readsize;
+}
+
+static off64_t fd_seek_from_mmap(FileData *filedata, off64_t offset, int whence)
+{
+  off64_t new_pos;
+  if (whence == SEEK_CUR) {
+    new_pos = filedata->file_offset + offset;
+  }
+  else if (whence == SEEK_SET) {
+    new_pos = offset;
+  }
+  else if (whence == SEEK_END) {
+    new_pos = (off64_t)filedata->buffersize + offset;
+  }
+  else {
+    return -1;
+  }
+
+  if (new_pos < 0 || new_pos > (off64_t)filedata->buffersize) {
+    return -1;
+  }
+
+  filedata->file_offset = new_pos;
+  return filedata->file_offset;
+}
+
 /* MemFile reading. */
 
 static int fd_read_from_memfile(FileData *filedata,
@@ -1357,6 +1468,8 @@ static FileData *blo_filedata_from_file_descriptor(const char *filepath,
 {
   FileDataReadFn *read_fn = NULL;
   FileDataSeekFn *seek_fn = NULL; /* Optional. */
+  size_t buffersize = 0;
+  BLI_mmap_file *mmap_file = NULL;
 
   gzFile gzfile = (gzFile)Z_NULL;
 
@@ -1379,6 +1492,17 @@ static FileData *blo_filedata_from_file_descriptor(const char *filepath,
   if (memcmp(header, "BLENDER", sizeof(header)) == 0) {
     read_fn = fd_read_data_from_file;
     seek_fn = fd_seek_data_from_file;
+
+    /* Prefer mapping the file, data is then only paged in when it's actually read. */
+    mmap_file = BLI_mmap_open(file);
+    if (mmap_file != NULL) {
+      read_fn = fd_read_from_mmap;
+      seek_fn = fd_seek_from_mmap;
+      buffersize = BLI_mmap_get_length(mmap_file);
+    }
+    else {
+      BLI_lseek(file, 0, SEEK_SET);
+    }
   }
 
   /* Gzip file. */
@@ -1414,6 +1538,8 @@ static FileData *blo_filedata_from_file_descriptor(const char *filepath,
 
   fd->read = read_fn;
   fd->seek = seek_fn;
+  fd->mmap_file = mmap_file;
+  fd->buffersize = buffersize;
 
   return fd;
 }
@@ -1481,10 +1607,19 @@ static int fd_read_gzip_from_memory(FileData *filedata,
   // Inflate another chunk.
   err = inflate(&filedata->strm, Z_SYNC_FLUSH);
 
-  if (err == Z_STREAM_END) {
+  /* Compressed files are written as multiple concatenated gzip members,
+   * continue with the next member while there is input left. */
+  while (err == Z_STREAM_END && filedata->strm.avail_in != 0 && filedata->strm.avail_out != 0) {
+    if (inflateReset(&filedata->strm) != Z_OK) {
+      break;
+    }
+    err = inflate(&filedata->strm, Z_SYNC_FLUSH);
+  }
+
+  if (err == Z_STREAM_END && filedata->strm.avail_in == 0) {
     return 0;
   }
-  if (err != Z_OK) {
+  if (!ELEM(err, Z_OK, Z_STREAM_END)) {
     printf("fd_read_gzip_from_memory: zlib error\n");
     return 0;
   }
@@ -1498,7 +1633,7 @@ static int fd_read_gzip_from_memory_init(FileData *fd)
 {
 
   fd->strm.next_in = (Bytef *)fd->buffer;
-  fd->strm.avail_in = fd->buffersize;
+  fd->strm.avail_in = (uInt)fd->buffersize;
   fd->strm.total_out = 0;
   fd->strm.zalloc = Z_NULL;
   fd->strm.zfree = Z_NULL;
@@ -1571,6 +1706,11 @@ void blo_filedata_free(FileData *fd)
       gzclose(fd->gzfiledes);
     }
 
+    if (fd->mmap_file) {
+      BLI_mmap_free(fd->mmap_file);
+      fd->mmap_file = NULL;
+    }
+
     if (fd->strm.next_in) {
       if (inflateEnd(&fd->strm) != Z_OK) {
         printf("close gzip stream error\n");
@@ -1588,7 +1728,7 @@ void blo_filedata_free(FileData *fd)
 #else
     /* Sanity check we're not keeping memory we don't need. */
     LISTBASE_FOREACH_MUTABLE (BHeadN *, new_bhead, &fd->bhead_list) {
-      if (fd->seek != NULL && BHEAD_USE_READ_ON_DEMAND(&new_bhead->bhead)) {
+      if (fd->seek != NULL && BHEAD_USE_READ_ON_DEMAND(fd, &new_bhead->bhead)) {
         BLI_assert(new_bhead->has_data == 0);
       }
       MEM_freeN(new_bhead);
@@ -2159,6 +2299,72 @@ static void switch_endian_structs(const struct SDNA *filesdna, BHead *bhead)
   }
 }
 
+/**
+ * Arrays with at least this many elements are reconstructed in parallel,
+ * smaller arrays aren't worth the threading overhead.
+ */
+#define READ_STRUCT_PARALLEL_BLOCKS_MIN 1024
+
+typedef struct ReadStructReconstructData {
+  const FileData *fd;
+  int SDNAnr;
+  int blocks;
+  size_t oldlen, curlen;
+  const char *data;
+  char *cur;
+} ReadStructReconstructData;
+
+static void read_struct_reconstruct_cb(void *__restrict userdata,
+                                       const int chunk,
+                                       const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const ReadStructReconstructData *rd = userdata;
+  const int start = chunk * READ_STRUCT_PARALLEL_BLOCKS_MIN;
+  const int blocks = min_ii(rd->blocks - start, READ_STRUCT_PARALLEL_BLOCKS_MIN);
+
+  DNA_struct_reconstruct_into(rd->fd->memsdna,
+                              rd->fd->filesdna,
+                              rd->fd->compflags,
+                              rd->SDNAnr,
+                              blocks,
+                              rd->data + (size_t)start * rd->oldlen,
+                              rd->cur + (size_t)start * rd->curlen);
+}
+
+/**
+ * Same as #DNA_struct_reconstruct, but large arrays (mesh data for example)
+ * are split in chunks that are converted on multiple threads.
+ */
+static void *read_struct_reconstruct(FileData *fd, BHead *bh, const void *data)
+{
+  if (bh->nr < READ_STRUCT_PARALLEL_BLOCKS_MIN * 2) {
+    return DNA_struct_reconstruct(
+        fd->memsdna, fd->filesdna, fd->compflags, bh->SDNAnr, bh->nr, data);
+  }
+
+  const int curlen = DNA_struct_reconstruct_size(fd->memsdna, fd->filesdna, bh->SDNAnr);
+  if (curlen == 0) {
+    return NULL;
+  }
+
+  ReadStructReconstructData rd = {
+      .fd = fd,
+      .SDNAnr = bh->SDNAnr,
+      .blocks = bh->nr,
+      .oldlen = (size_t)fd->filesdna->types_size[fd->filesdna->structs[bh->SDNAnr][0]],
+      .curlen = (size_t)curlen,
+      .data = data,
+      .cur = MEM_callocN((size_t)bh->nr * (size_t)curlen, "reconstruct"),
+  };
+  const int chunks = (int)divide_ceil_u((uint)bh->nr, READ_STRUCT_PARALLEL_BLOCKS_MIN);
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  BLI_task_parallel_range(0, chunks, &rd, read_struct_reconstruct_cb, &settings);
+
+  return rd.cur;
+}
+
 static void *read_struct(FileData *fd, BHead *bh, const char *blockname)
 {
   void *temp = NULL;
@@ -2184,17 +2390,33 @@ static void *read_struct(FileData *fd, BHead *bh, const char *blockname)
 
     if (fd->compflags[bh->SDNAnr] != SDNA_CMP_REMOVED) {
       if (fd->compflags[bh->SDNAnr] == SDNA_CMP_NOT_EQUAL) {
+        const void *data = (bh + 1);
 #ifdef USE_BHEAD_READ_ON_DEMAND
+        const void *data_mapped = NULL;
         if (BHEADN_FROM_BHEAD(bh)->has_data == false) {
-          bh = blo_bhead_read_full(fd, bh);
-          if (UNLIKELY(bh == NULL)) {
-            fd->flags &= ~FD_FLAGS_FILE_OK;
-            return NULL;
+          /* Reconstruct directly from the mapped file when possible. */
+          data_mapped = blo_bhead_data_mapped(fd, bh);
+          if (data_mapped != NULL) {
+            data = data_mapped;
+          }
+          else {
+            bh = blo_bhead_read_full(fd, bh);
+            if (UNLIKELY(bh == NULL)) {
+              fd->flags &= ~FD_FLAGS_FILE_OK;
+              return NULL;
+            }
+            data = (bh + 1);
           }
         }
 #endif
-        temp = DNA_struct_reconstruct(
-            fd->memsdna, fd->filesdna, fd->compflags, bh->SDNAnr, bh->nr, (bh + 1));
+        temp = read_struct_reconstruct(fd, bh, data);
+#ifdef USE_BHEAD_READ_ON_DEMAND
+        if (data_mapped != NULL && UNLIKELY(BLI_mmap_any_io_error(fd->mmap_file))) {
+          fd->flags &= ~FD_FLAGS_FILE_OK;
+          MEM_freeN(temp);
+          temp = NULL;
+        }
+#endif
       }
       else {
         /* SDNA_CMP_EQUAL */
@@ -8998,6 +9220,16 @@ static BHead *read_data_into_datamap(FileData *fd, BHead *bhead, const char *all
 {
   bhead = blo_bhead_next(fd, bhead);
 
+  /* Size the map for all data-blocks at once, only headers are read here. */
+  {
+    int data_len = 0;
+    for (BHead *bhead_iter = bhead; bhead_iter && bhead_iter->code == DATA;
+         bhead_iter = blo_bhead_next(fd, bhead_iter)) {
+      data_len++;
+    }
+    oldnewmap_reserve(fd->datamap, data_len);
+  }
+
   while (bhead && bhead->code == DATA) {
     /* The code below is useful for debugging leaks in data read from the blend file.
      * Without this the messages only tell us what ID-type the memory came from,
@@ -9890,6 +10122,19 @@ BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath)
     }
   }
 
+  if ((fd->skip_flags & BLO_READ_SKIP_DATA) == 0) {
+    /* Every ID gets an entry in the libmap, size it once instead of growing it while reading.
+     * Only block headers are read here (data is read on demand when possible). */
+    int id_bhead_len = 0;
+    for (BHead *bhead_iter = bhead; bhead_iter && bhead_iter->code != ENDB;
+         bhead_iter = blo_bhead_next(fd, bhead_iter)) {
+      if (bhead_iter->code != DATA) {
+        id_bhead_len++;
+      }
+    }
+    oldnewmap_reserve(fd->libmap, id_bhead_len);
+  }
+
   while (bhead) {
     switch (bhead->code) {
       case DATA:
@@ -29,6 +29,7 @@
 #include "DNA_windowmanager_types.h" /* for ReportType */
 #include "zlib.h"
 
+struct BLI_mmap_file;
 struct BLOCacheStorage;
 struct GSet;
 struct IDNameLib_Map;
@@ -72,7 +73,7 @@ typedef struct FileData {
   ListBase bhead_list;
   enum eFileDataFlag flags;
   bool is_eof;
-  int buffersize;
+  size_t buffersize;
   int64_t file_offset;
 
   FileDataReadFn *read;
@@ -80,6 +81,8 @@ typedef struct FileData {
 
   /** Regular file reading. */
   int filedes;
+  /** Memory-mapped regular file reading, see #BLI_mmap_open. */
+  struct BLI_mmap_file *mmap_file;
 
   /** Variables needed for reading from memory / stream. */
   const char *buffer;
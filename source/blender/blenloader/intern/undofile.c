@@ -192,6 +192,46 @@ void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, uint siz
   }
 }
 
+/**
+ * Add all chunks written for the ID matching \a id_session_uuid in the reference memfile,
+ * sharing their memory, instead of writing (and comparing) that ID again.
+ *
+ * \return false when the reference memfile has no chunks for that ID,
+ * in which case it has to be written as usual.
+ */
+bool BLO_memfile_chunk_add_from_reference(MemFileWriteData *mem_data, uint id_session_uuid)
+{
+  if (mem_data->id_session_uuid_mapping == NULL) {
+    return false;
+  }
+
+  MemFileChunk *compchunk = BLI_ghash_lookup(mem_data->id_session_uuid_mapping,
+                                             POINTER_FROM_UINT(id_session_uuid));
+  if (compchunk == NULL) {
+    return false;
+  }
+
+  MemFile *memfile = mem_data->written_memfile;
+
+  /* Chunks of an ID are always written contiguously. */
+  for (; compchunk != NULL && compchunk->id_session_uuid == id_session_uuid;
+       compchunk = compchunk->next) {
+    MemFileChunk *curchunk = MEM_mallocN(sizeof(MemFileChunk), "MemFileChunk");
+    curchunk->size = compchunk->size;
+    curchunk->buf = compchunk->buf;
+    curchunk->is_identical = true;
+    curchunk->is_identical_future = true;
+    curchunk->id_session_uuid = id_session_uuid;
+    BLI_addtail(&memfile->chunks, curchunk);
+
+    compchunk->is_identical_future = true;
+  }
+
+  mem_data->reference_current_chunk = compchunk;
+
+  return true;
+}
+
 struct Main *BLO_memfile_main_get(struct MemFile *memfile,
                                   struct Main *oldmain,
                                   struct Scene **r_scene)
@@ -148,7 +148,9 @@
 
 #include "BLI_bitmap.h"
 #include "BLI_blenlib.h"
+#include "BLI_math_base.h"
 #include "BLI_mempool.h"
+#include "BLI_task.h"
 #include "MEM_guardedalloc.h"  // MEM_freeN
 
 #include "BKE_action.h"
@@ -225,6 +227,7 @@ struct WriteWrap {
   union {
     int file_handle;
     gzFile gz_handle;
+    struct ZlibWriteData *zlib_handle;
   } _user_data;
 };
 
@@ -255,28 +258,178 @@ static size_t ww_write_none(WriteWrap *ww, const char *buf, size_t buf_len)
 #undef FILE_HANDLE
 
 /* zlib */
-#define FILE_HANDLE(ww) (ww)->_user_data.gz_handle
+
+/**
+ * Compress using multiple threads: data is split into chunks of #ZLIB_CHUNK_SIZE,
+ * each chunk is deflated on its own and written as a separate gzip member.
+ *
+ * A sequence of gzip members is itself a valid gzip stream (see RFC 1952),
+ * so files remain readable by `gzread` (used when reading compressed files)
+ * as well as any other gzip reader.
+ */
+#define ZLIB_CHUNK_SIZE (1 << 20) /* 1mb */
+/* Matches the compression level previously used with `gzopen`. */
+#define ZLIB_LEVEL 1
+/* #deflateBound without a stream assumes a zlib wrapper, reserve room for the gzip one. */
+#define ZLIB_GZIP_WRAPPER_SIZE 18
+
+typedef struct ZlibChunk {
+  /** Uncompressed data. */
+  char *in;
+  size_t in_len;
+  /** Compressed data, a complete gzip member. */
+  char *out;
+  size_t out_len;
+  size_t out_alloc_len;
+  bool error;
+} ZlibChunk;
+
+typedef struct ZlibWriteData {
+  int file_handle;
+  /** Chunks which are compressed in parallel before being written out in order. */
+  ZlibChunk *chunks;
+  int chunks_len;
+  /** Index of the chunk being filled. */
+  int chunk_active;
+  bool error;
+} ZlibWriteData;
+
+#define FILE_HANDLE(ww) (ww)->_user_data.zlib_handle
+
+static void ww_zlib_compress_chunk_cb(void *__restrict userdata,
+                                      const int index,
+                                      const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  ZlibWriteData *zwd = userdata;
+  ZlibChunk *chunk = &zwd->chunks[index];
+  z_stream strm = {NULL};
+
+  chunk->out_len = 0;
+  chunk->error = true;
+
+  /* Adding 16 to the window bits writes a gzip header & footer. */
+  if (deflateInit2(&strm, ZLIB_LEVEL, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY) !=
+      Z_OK) {
+    return;
+  }
+
+  strm.next_in = (Bytef *)chunk->in;
+  strm.avail_in = (uInt)chunk->in_len;
+  strm.next_out = (Bytef *)chunk->out;
+  strm.avail_out = (uInt)chunk->out_alloc_len;
+
+  /* The output buffer is allocated using #deflateBound, a single call always finishes. */
+  if (deflate(&strm, Z_FINISH) == Z_STREAM_END) {
+    chunk->out_len = chunk->out_alloc_len - strm.avail_out;
+    chunk->error = false;
+  }
+
+  deflateEnd(&strm);
+}
+
+/**
+ * Compress all filled chunks in parallel, then write them in order.
+ */
+static void ww_zlib_flush_chunks(ZlibWriteData *zwd)
+{
+  int chunks_used = zwd->chunk_active + 1;
+  if (zwd->chunks[zwd->chunk_active].in_len == 0) {
+    chunks_used -= 1;
+  }
+
+  if (chunks_used > 0 && !zwd->error) {
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.use_threading = (chunks_used > 1);
+    settings.min_iter_per_thread = 1;
+    BLI_task_parallel_range(0, chunks_used, zwd, ww_zlib_compress_chunk_cb, &settings);
+
+    for (int i = 0; i < chunks_used; i++) {
+      const ZlibChunk *chunk = &zwd->chunks[i];
+      if (chunk->error ||
+          (size_t)write(zwd->file_handle, chunk->out, chunk->out_len) != chunk->out_len) {
+        zwd->error = true;
+        break;
+      }
+    }
+  }
+
+  for (int i = 0; i < zwd->chunks_len; i++) {
+    zwd->chunks[i].in_len = 0;
+  }
+  zwd->chunk_active = 0;
+}
 
 static bool ww_open_zlib(WriteWrap *ww, const char *filepath)
 {
-  gzFile file;
+  int file;
 
-  file = BLI_gzopen(filepath, "wb1");
+  file = BLI_open(filepath, O_BINARY + O_WRONLY + O_CREAT + O_TRUNC, 0666);
 
-  if (file != Z_NULL) {
-    FILE_HANDLE(ww) = file;
-    return true;
+  if (file == -1) {
+    return false;
   }
 
-  return false;
+  ZlibWriteData *zwd = MEM_callocN(sizeof(*zwd), __func__);
+  zwd->file_handle = file;
+  /* Enough chunks to keep all threads busy. */
+  zwd->chunks_len = max_ii(BLI_task_scheduler_num_threads(), 1);
+  zwd->chunks = MEM_calloc_arrayN(zwd->chunks_len, sizeof(*zwd->chunks), __func__);
+
+  const size_t out_alloc_len = deflateBound(NULL, ZLIB_CHUNK_SIZE) + ZLIB_GZIP_WRAPPER_SIZE;
+  for (int i = 0; i < zwd->chunks_len; i++) {
+    ZlibChunk *chunk = &zwd->chunks[i];
+    chunk->in = MEM_mallocN(ZLIB_CHUNK_SIZE, __func__);
+    chunk->out = MEM_mallocN(out_alloc_len, __func__);
+    chunk->out_alloc_len = out_alloc_len;
+  }
+
+  FILE_HANDLE(ww) = zwd;
+  return true;
 }
 static bool ww_close_zlib(WriteWrap *ww)
 {
-  return (gzclose(FILE_HANDLE(ww)) == Z_OK);
+  ZlibWriteData *zwd = FILE_HANDLE(ww);
+
+  ww_zlib_flush_chunks(zwd);
+
+  bool ok = !zwd->error;
+  if (close(zwd->file_handle) == -1) {
+    ok = false;
+  }
+
+  for (int i = 0; i < zwd->chunks_len; i++) {
+    MEM_freeN(zwd->chunks[i].in);
+    MEM_freeN(zwd->chunks[i].out);
+  }
+  MEM_freeN(zwd->chunks);
+  MEM_freeN(zwd);
+
+  return ok;
 }
 static size_t ww_write_zlib(WriteWrap *ww, const char *buf, size_t buf_len)
 {
-  return gzwrite(FILE_HANDLE(ww), buf, buf_len);
+  ZlibWriteData *zwd = FILE_HANDLE(ww);
+  size_t buf_written = 0;
+
+  while (buf_written < buf_len && !zwd->error) {
+    ZlibChunk *chunk = &zwd->chunks[zwd->chunk_active];
+    const size_t len = MIN2(buf_len - buf_written, ZLIB_CHUNK_SIZE - chunk->in_len);
+    memcpy(chunk->in + chunk->in_len, buf + buf_written, len);
+    chunk->in_len += len;
+    buf_written += len;
+
+    if (chunk->in_len == ZLIB_CHUNK_SIZE) {
+      if (zwd->chunk_active + 1 == zwd->chunks_len) {
+        ww_zlib_flush_chunks(zwd);
+      }
+      else {
+        zwd->chunk_active += 1;
+      }
+    }
+  }
+
+  return zwd->error ? 0 : buf_len;
 }
 #undef FILE_HANDLE
 
@@ -4024,6 +4177,33 @@ static void write_thumb(WriteData *wd, const BlendThumbnail *thumb)
  * \{ */
 
 /* if MemFile * there's filesave to memory */
+/**
+ * Whether \a id wasn't tagged for any update since the last undo push,
+ * in which case the undo memory of the previous step can be used as-is.
+ *
+ * Only used with #UserDef_Experimental.use_undo_skip_unchanged_ids,
+ * since not all changes to IDs go through the depsgraph tagging.
+ */
+static bool write_id_is_unchanged_since_undo_push(ID *id)
+{
+  /* These types are known to be modified without any tagging
+   * (UI data, text editing, paint settings...). */
+  if (ELEM(GS(id->name), ID_WM, ID_WS, ID_SCR, ID_SCE, ID_TXT, ID_BR, ID_PAL, ID_PC)) {
+    return false;
+  }
+
+  if (id->recalc_after_undo_push != 0) {
+    return false;
+  }
+
+  bNodeTree *nodetree = ntreeFromID(id);
+  if (nodetree != NULL && nodetree->id.recalc_after_undo_push != 0) {
+    return false;
+  }
+
+  return true;
+}
+
 static bool write_file_handle(Main *mainvar,
                               WriteWrap *ww,
                               MemFile *compare,
@@ -4062,6 +4242,9 @@ static bool write_file_handle(Main *mainvar,
                                                  NULL :
                                                  BKE_lib_override_library_operations_store_init();
 
+  const bool use_undo_skip_unchanged_ids = wd->use_memfile &&
+                                           USER_EXPERIMENTAL_TEST(&U, use_undo_skip_unchanged_ids);
+
 #define ID_BUFFER_STATIC_SIZE 8192
   /* This outer loop allows to save first data-blocks from real mainvar,
    * then the temp ones from override process,
@@ -4099,6 +4282,9 @@ static bool write_file_handle(Main *mainvar,
         }
 
         if (wd->use_memfile) {
+          const bool id_is_unchanged = use_undo_skip_unchanged_ids &&
+                                       write_id_is_unchanged_since_undo_push(id);
+
           /* Record the changes that happened up to this undo push in
            * recalc_up_to_undo_push, and clear recalc_after_undo_push again
            * to start accumulating for the next undo push. */
@@ -4118,6 +4304,11 @@ static bool write_file_handle(Main *mainvar,
               scene->master_collection->id.recalc_after_undo_push = 0;
             }
           }
+
+          /* Skip serializing and comparing the ID, share the previous undo step's memory. */
+          if (id_is_unchanged && BLO_memfile_chunk_add_from_reference(&wd->mem, id->session_uuid)) {
+            continue;
+          }
         }
 
         mywrite_id_begin(wd, id);
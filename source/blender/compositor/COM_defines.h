@@ -58,6 +58,18 @@ typedef enum CompositorPriority {
   COM_PRIORITY_LOW = 0,
 } CompositorPriority;
 
+/**
+ * \brief Possible execution models of the compositor
+ * \see CompositorContext.executionModel
+ * \ingroup Execution
+ */
+typedef enum CompositorExecutionModel {
+  /** \brief Output tiles are scheduled on demand, after the areas of the buffers they read */
+  COM_EXECUTION_MODEL_TILED = 0,
+  /** \brief Execution groups are executed one after the other over their whole area */
+  COM_EXECUTION_MODEL_FULL_FRAME = 1,
+} CompositorExecutionModel;
+
 // configurable items
 
 // chunk size determination
@@ -0,0 +1,104 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2020, Blender Foundation.
+ */
+
+#include <list>
+
+#include "COM_BufferCache.h"
+#include "COM_MemoryBuffer.h"
+
+#include "DNA_userdef_types.h"
+
+struct BufferCacheEntry {
+  uint64_t key;
+  MemoryBuffer *buffer;
+  size_t size;
+};
+
+/* Most recently used first. */
+static std::list<BufferCacheEntry> g_entries;
+static size_t g_size = 0;
+
+static size_t buffer_size(MemoryBuffer *buffer)
+{
+  return sizeof(float) * buffer->getWidth() * buffer->getHeight() * buffer->get_num_channels();
+}
+
+uint64_t BufferCache::hash(uint64_t hash, const void *data, size_t size)
+{
+  const unsigned char *bytes = (const unsigned char *)data;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+MemoryBuffer *BufferCache::take(uint64_t key, MemoryBuffer *like)
+{
+  for (std::list<BufferCacheEntry>::iterator it = g_entries.begin(); it != g_entries.end();
+       ++it) {
+    if (it->key != key) {
+      continue;
+    }
+    MemoryBuffer *buffer = it->buffer;
+    g_size -= it->size;
+    g_entries.erase(it);
+
+    if (buffer->getWidth() != like->getWidth() || buffer->getHeight() != like->getHeight() ||
+        buffer->get_num_channels() != like->get_num_channels()) {
+      delete buffer;
+      return NULL;
+    }
+    return buffer;
+  }
+  return NULL;
+}
+
+void BufferCache::put(uint64_t key, MemoryBuffer *buffer)
+{
+  const size_t limit = (size_t)U.memcachelimit * 1024 * 1024;
+  const size_t size = buffer_size(buffer);
+
+  delete take(key, buffer);
+  if (size > limit) {
+    delete buffer;
+    return;
+  }
+
+  while (g_size + size > limit) {
+    BufferCacheEntry &entry = g_entries.back();
+    g_size -= entry.size;
+    delete entry.buffer;
+    g_entries.pop_back();
+  }
+
+  buffer->setMemoryProxy(NULL);
+  BufferCacheEntry entry = {key, buffer, size};
+  g_entries.push_front(entry);
+  g_size += size;
+}
+
+void BufferCache::clear()
+{
+  for (std::list<BufferCacheEntry>::iterator it = g_entries.begin(); it != g_entries.end();
+       ++it) {
+    delete it->buffer;
+  }
+  g_entries.clear();
+  g_size = 0;
+}
@@ -0,0 +1,63 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2020, Blender Foundation.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+class MemoryBuffer;
+
+/**
+ * \brief Keeps the buffers written by execution groups between executions of the compositor,
+ * so parts of the node tree that did not change are not calculated again.
+ *
+ * Buffers are identified by a key, a hash of the settings of all nodes the buffer depends on,
+ * see NodeOperationBuilder.determine_cache_keys. A key of 0 means the buffer can't be cached.
+ *
+ * The total size of the cache is limited by the memory cache limit of the user preferences,
+ * the least recently used buffers are freed first.
+ * Only accessed from #COM_execute, which is serialized by its mutex.
+ * \ingroup Memory
+ */
+class BufferCache {
+ public:
+  /** Initial value to pass to #hash. */
+  static const uint64_t hash_init = 14695981039346656037ULL;
+
+  /**
+   * \brief add \a size bytes of \a data to \a hash (FNV-1a)
+   */
+  static uint64_t hash(uint64_t hash, const void *data, size_t size);
+
+  /**
+   * \brief take the buffer stored with \a key out of the cache
+   * \return NULL when there is no buffer for \a key with the same size as \a like
+   */
+  static MemoryBuffer *take(uint64_t key, MemoryBuffer *like);
+
+  /**
+   * \brief store \a buffer with \a key, the cache takes ownership of the buffer
+   */
+  static void put(uint64_t key, MemoryBuffer *buffer);
+
+  /**
+   * \brief free all cached buffers
+   */
+  static void clear();
+};
@@ -77,6 +77,11 @@ class CompositorContext {
    */
   bool m_fastCalculation;
 
+  /**
+   * \brief How the execution groups are scheduled
+   */
+  CompositorExecutionModel m_executionModel;
+
   /* \brief color management settings */
   const ColorManagedViewSettings *m_viewSettings;
   const ColorManagedDisplaySettings *m_displaySettings;
@@ -263,6 +268,14 @@ class CompositorContext {
   {
     return this->m_fastCalculation;
   }
+  void setExecutionModel(CompositorExecutionModel executionModel)
+  {
+    this->m_executionModel = executionModel;
+  }
+  CompositorExecutionModel getExecutionModel() const
+  {
+    return this->m_executionModel;
+  }
   bool isGroupnodeBufferEnabled() const
   {
     return (this->getbNodeTree()->flag & NTREE_COM_GROUPNODE_BUFFER) != 0;
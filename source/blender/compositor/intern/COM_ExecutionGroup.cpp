@@ -46,6 +46,8 @@ ExecutionGroup::ExecutionGroup()
   this->m_isOutput = false;
   this->m_complex = false;
   this->m_chunkExecutionStates = NULL;
+  this->m_chunkOrder = NULL;
+  this->m_scheduleStartIndex = 0;
   this->m_bTree = NULL;
   this->m_height = 0;
   this->m_width = 0;
@@ -188,22 +190,18 @@ void ExecutionGroup::determineNumberOfChunks()
   }
 }
 
-/**
- * this method is called for the top execution groups. containing the compositor node or the
- * preview node or the viewer node)
- */
-void ExecutionGroup::execute(ExecutionSystem *graph)
+bool ExecutionGroup::beginExecution(ExecutionSystem *graph)
 {
   const CompositorContext &context = graph->getContext();
   const bNodeTree *bTree = context.getbNodeTree();
   if (this->m_width == 0 || this->m_height == 0) {
-    return;
+    return false;
   }  /// \note Break out... no pixels to calculate.
   if (bTree->test_break && bTree->test_break(bTree->tbh)) {
-    return;
+    return false;
   }  /// \note Early break out for blur and preview nodes.
   if (this->m_numberOfChunks == 0) {
-    return;
+    return false;
   }  /// \note Early break out.
   unsigned int chunkNumber;
 
@@ -319,56 +317,99 @@ void ExecutionGroup::execute(ExecutionSystem *graph)
       break;
   }
 
+  this->m_chunkOrder = chunkOrder;
+  this->m_scheduleStartIndex = 0;
+
   DebugInfo::execution_group_started(this);
   DebugInfo::graphviz(graph);
+  return true;
+}
 
-  bool breaked = false;
-  bool finished = false;
-  unsigned int startIndex = 0;
+bool ExecutionGroup::scheduleNextChunks(ExecutionSystem *graph)
+{
+  const bNodeTree *bTree = this->m_bTree;
+  const CompositorPriority priority = this->getRenderPriotrity();
   const int maxNumberEvaluated = BLI_system_thread_count() * 2;
-
-  while (!finished && !breaked) {
-    bool startEvaluated = false;
-    finished = true;
-    int numberEvaluated = 0;
-
-    for (index = startIndex;
-         index < this->m_numberOfChunks && numberEvaluated < maxNumberEvaluated;
-         index++) {
-      chunkNumber = chunkOrder[index];
-      int yChunk = chunkNumber / this->m_numberOfXChunks;
-      int xChunk = chunkNumber - (yChunk * this->m_numberOfXChunks);
-      const ChunkExecutionState state = this->m_chunkExecutionStates[chunkNumber];
-      if (state == COM_ES_NOT_SCHEDULED) {
-        scheduleChunkWhenPossible(graph, xChunk, yChunk);
-        finished = false;
-        startEvaluated = true;
-        numberEvaluated++;
-
-        if (bTree->update_draw) {
-          bTree->update_draw(bTree->udh);
-        }
-      }
-      else if (state == COM_ES_SCHEDULED) {
-        finished = false;
-        startEvaluated = true;
-        numberEvaluated++;
-      }
-      else if (state == COM_ES_EXECUTED && !startEvaluated) {
-        startIndex = index + 1;
+  bool startEvaluated = false;
+  bool finished = true;
+  int numberEvaluated = 0;
+
+  for (unsigned int index = this->m_scheduleStartIndex;
+       index < this->m_numberOfChunks && numberEvaluated < maxNumberEvaluated;
+       index++) {
+    const unsigned int chunkNumber = this->m_chunkOrder[index];
+    int yChunk = chunkNumber / this->m_numberOfXChunks;
+    int xChunk = chunkNumber - (yChunk * this->m_numberOfXChunks);
+    const ChunkExecutionState state = this->m_chunkExecutionStates[chunkNumber];
+    if (state == COM_ES_NOT_SCHEDULED) {
+      scheduleChunkWhenPossible(graph, xChunk, yChunk, priority);
+      finished = false;
+      startEvaluated = true;
+      numberEvaluated++;
+
+      if (bTree->update_draw) {
+        bTree->update_draw(bTree->udh);
       }
     }
-
-    WorkScheduler::finish();
-
-    if (bTree->test_break && bTree->test_break(bTree->tbh)) {
-      breaked = true;
+    else if (state == COM_ES_SCHEDULED) {
+      finished = false;
+      startEvaluated = true;
+      numberEvaluated++;
+    }
+    else if (state == COM_ES_EXECUTED && !startEvaluated) {
+      this->m_scheduleStartIndex = index + 1;
     }
   }
+
+  return finished;
+}
+
+void ExecutionGroup::endExecution(ExecutionSystem *graph)
+{
   DebugInfo::execution_group_finished(this);
   DebugInfo::graphviz(graph);
 
-  MEM_freeN(chunkOrder);
+  MEM_freeN(this->m_chunkOrder);
+  this->m_chunkOrder = NULL;
+}
+
+void ExecutionGroup::executeFullFrame(ExecutionSystem *graph)
+{
+  const CompositorContext &context = graph->getContext();
+  const bNodeTree *bTree = context.getbNodeTree();
+  if (this->m_width == 0 || this->m_height == 0 || this->m_numberOfChunks == 0) {
+    return;
+  }
+
+  this->m_executionStartTime = PIL_check_seconds_timer();
+  this->m_chunksFinished = 0;
+  this->m_bTree = bTree;
+
+  DebugInfo::execution_group_started(this);
+
+  for (unsigned int chunkNumber = 0; chunkNumber < this->m_numberOfChunks; chunkNumber++) {
+    scheduleChunk(chunkNumber, this->getRenderPriotrity());
+  }
+  WorkScheduler::finish();
+
+  DebugInfo::execution_group_finished(this);
+}
+
+void ExecutionGroup::markExecuted()
+{
+  for (unsigned int index = 0; index < this->m_numberOfChunks; index++) {
+    this->m_chunkExecutionStates[index] = COM_ES_EXECUTED;
+  }
+}
+
+bool ExecutionGroup::isExecuted() const
+{
+  for (unsigned int index = 0; index < this->m_numberOfChunks; index++) {
+    if (this->m_chunkExecutionStates[index] != COM_ES_EXECUTED) {
+      return false;
+    }
+  }
+  return true;
 }
 
 MemoryBuffer **ExecutionGroup::getInputBuffersOpenCL(int chunkNumber)
@@ -481,10 +522,12 @@ MemoryBuffer *ExecutionGroup::allocateOutputBuffer(int /*chunkNumber*/, rcti *re
   return NULL;
 }
 
-bool ExecutionGroup::scheduleAreaWhenPossible(ExecutionSystem *graph, rcti *area)
+bool ExecutionGroup::scheduleAreaWhenPossible(ExecutionSystem *graph,
+                                              rcti *area,
+                                              CompositorPriority priority)
 {
   if (this->m_singleThreaded) {
-    return scheduleChunkWhenPossible(graph, 0, 0);
+    return scheduleChunkWhenPossible(graph, 0, 0, priority);
   }
   // find all chunks inside the rect
   // determine minxchunk, minychunk, maxxchunk, maxychunk where x and y are chunknumbers
@@ -506,7 +549,7 @@ bool ExecutionGroup::scheduleAreaWhenPossible(ExecutionSystem *graph, rcti *area
   bool result = true;
   for (indexx = minxchunk; indexx < maxxchunk; indexx++) {
     for (indexy = minychunk; indexy < maxychunk; indexy++) {
-      if (!scheduleChunkWhenPossible(graph, indexx, indexy)) {
+      if (!scheduleChunkWhenPossible(graph, indexx, indexy, priority)) {
         result = false;
       }
     }
@@ -515,17 +558,20 @@ bool ExecutionGroup::scheduleAreaWhenPossible(ExecutionSystem *graph, rcti *area
   return result;
 }
 
-bool ExecutionGroup::scheduleChunk(unsigned int chunkNumber)
+bool ExecutionGroup::scheduleChunk(unsigned int chunkNumber, CompositorPriority priority)
 {
   if (this->m_chunkExecutionStates[chunkNumber] == COM_ES_NOT_SCHEDULED) {
     this->m_chunkExecutionStates[chunkNumber] = COM_ES_SCHEDULED;
-    WorkScheduler::schedule(this, chunkNumber);
+    WorkScheduler::schedule(this, chunkNumber, priority);
     return true;
   }
   return false;
 }
 
-bool ExecutionGroup::scheduleChunkWhenPossible(ExecutionSystem *graph, int xChunk, int yChunk)
+bool ExecutionGroup::scheduleChunkWhenPossible(ExecutionSystem *graph,
+                                               int xChunk,
+                                               int yChunk,
+                                               CompositorPriority priority)
 {
   if (xChunk < 0 || xChunk >= (int)this->m_numberOfXChunks) {
     return true;
@@ -563,7 +609,7 @@ bool ExecutionGroup::scheduleChunkWhenPossible(ExecutionSystem *graph, int xChun
     ExecutionGroup *group = memoryProxy->getExecutor();
 
     if (group != NULL) {
-      if (!group->scheduleAreaWhenPossible(graph, &area)) {
+      if (!group->scheduleAreaWhenPossible(graph, &area, priority)) {
         canBeExecuted = false;
       }
     }
@@ -573,7 +619,7 @@ bool ExecutionGroup::scheduleChunkWhenPossible(ExecutionSystem *graph, int xChun
   }
 
   if (canBeExecuted) {
-    scheduleChunk(chunkNumber);
+    scheduleChunk(chunkNumber, priority);
   }
 
   return false;
@@ -158,6 +158,16 @@ class ExecutionGroup {
    */
   ChunkExecutionState *m_chunkExecutionStates;
 
+  /**
+   * \brief order in which the chunks are scheduled, only valid during execution
+   */
+  unsigned int *m_chunkOrder;
+
+  /**
+   * \brief index in m_chunkOrder before which all chunks have been executed
+   */
+  unsigned int m_scheduleStartIndex;
+
   /**
    * \brief indicator when this ExecutionGroup has valid Operations in its vector for Execution
    * \note When building the ExecutionGroup Operations are added via recursion.
@@ -216,11 +226,15 @@ class ExecutionGroup {
    * \param graph:
    * \param xChunk:
    * \param yChunk:
+   * \param priority: priority of the output that needs the chunk
    * \return [true:false]
    * true: package(s) are scheduled
    * false: scheduling is deferred (depending workpackages are scheduled)
    */
-  bool scheduleChunkWhenPossible(ExecutionSystem *graph, int xChunk, int yChunk);
+  bool scheduleChunkWhenPossible(ExecutionSystem *graph,
+                                 int xChunk,
+                                 int yChunk,
+                                 CompositorPriority priority);
 
   /**
    * \brief try to schedule a specific area.
@@ -228,17 +242,19 @@ class ExecutionGroup {
    * \note This method is called from other ExecutionGroup's.
    * \param graph:
    * \param rect:
+   * \param priority: priority of the output that needs the area
    * \return [true:false]
    * true: package(s) are scheduled
    * false: scheduling is deferred (depending workpackages are scheduled)
    */
-  bool scheduleAreaWhenPossible(ExecutionSystem *graph, rcti *rect);
+  bool scheduleAreaWhenPossible(ExecutionSystem *graph, rcti *rect, CompositorPriority priority);
 
   /**
    * \brief add a chunk to the WorkScheduler.
    * \param chunknumber:
+   * \param priority: priority of the output that needs the chunk
    */
-  bool scheduleChunk(unsigned int chunkNumber);
+  bool scheduleChunk(unsigned int chunkNumber, CompositorPriority priority);
 
   /**
    * \brief determine the area of interest of a certain input area
@@ -382,22 +398,38 @@ class ExecutionGroup {
   void deinitExecution();
 
   /**
-   * \brief schedule an ExecutionGroup
-   * \note this method will return when all chunks have been calculated, or the execution has
-   * breaked (by user)
-   *
-   * first the order of the chunks will be determined. This is determined by finding the
-   * ViewerOperation and get the relevant information from it.
-   *   - ChunkOrdering
-   *   - CenterX
-   *   - CenterY
-   *
-   * After determining the order of the chunks the chunks will be scheduled
+   * \brief schedule an ExecutionGroup, in steps so the ExecutionSystem can run several groups
+   * at once.
+   * beginExecution determines the chunk order and returns false when there is nothing to
+   * execute. The order is taken from the ViewerOperation (ChunkOrdering, CenterX and CenterY)
+   * when the group outputs to one. Every scheduleNextChunks call schedules the chunks that can
+   * be scheduled within a window of the chunk order, and returns true when all chunks have been
+   * executed.
+   * Call WorkScheduler.waitForProgress between calls.
+   */
+  bool beginExecution(ExecutionSystem *system);
+  bool scheduleNextChunks(ExecutionSystem *system);
+  void endExecution(ExecutionSystem *system);
+
+  /**
+   * \brief schedule all chunks of this ExecutionGroup at once
+   * Used by the full frame execution model, where the ExecutionSystem calls this only after
+   * all ExecutionGroups this one reads from have been executed.
+   * Chunk order and area of interest are not taken into account.
    *
-   * \see ViewerOperation
-   * \param system:
+   * \see ExecutionSystem.executeFullFrame
    */
-  void execute(ExecutionSystem *system);
+  void executeFullFrame(ExecutionSystem *system);
+
+  /**
+   * \brief mark all chunks as executed, used when the buffer was restored from the BufferCache
+   */
+  void markExecuted();
+
+  /**
+   * \brief check if all chunks have been executed
+   */
+  bool isExecuted() const;
 
   /**
    * \brief this method determines the MemoryProxy's where this execution group depends on.
@@ -425,6 +457,14 @@ class ExecutionGroup {
     this->m_chunkSize = chunksize;
   }
 
+  /**
+   * \brief get the total number of chunks
+   */
+  unsigned int getNumberOfChunks() const
+  {
+    return this->m_numberOfChunks;
+  }
+
   /**
    * \brief get the Render priority of this ExecutionGroup
    * \see ExecutionSystem.execute
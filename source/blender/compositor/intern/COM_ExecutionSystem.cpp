@@ -18,6 +18,9 @@
 
 #include "COM_ExecutionSystem.h"
 
+#include <algorithm>
+#include <map>
+
 #include "BLI_utildefines.h"
 #include "PIL_time.h"
 
@@ -25,6 +28,9 @@
 
 #include "BLT_translation.h"
 
+#include "DNA_userdef_types.h"
+
+#include "COM_BufferCache.h"
 #include "COM_Converter.h"
 #include "COM_Debug.h"
 #include "COM_ExecutionGroup.h"
@@ -32,6 +38,7 @@
 #include "COM_NodeOperationBuilder.h"
 #include "COM_ReadBufferOperation.h"
 #include "COM_WorkScheduler.h"
+#include "COM_WriteBufferOperation.h"
 
 #ifdef WITH_CXX_GUARDEDALLOC
 #  include "MEM_guardedalloc.h"
@@ -51,6 +58,9 @@ ExecutionSystem::ExecutionSystem(RenderData *rd,
   this->m_context.setbNodeTree(editingtree);
   this->m_context.setPreviewHash(editingtree->previews);
   this->m_context.setFastCalculation(fastcalculation);
+  this->m_context.setExecutionModel(USER_EXPERIMENTAL_TEST(&U, use_full_frame_compositor) ?
+                                        COM_EXECUTION_MODEL_FULL_FRAME :
+                                        COM_EXECUTION_MODEL_TILED);
   /* initialize the CompositorContext */
   if (rendering) {
     this->m_context.setQuality((CompositorQuality)editingtree->render_quality);
@@ -177,17 +187,33 @@ void ExecutionSystem::execute()
     executionGroup->initExecution();
   }
 
+  restoreCachedBuffers();
+
   WorkScheduler::start(this->m_context);
 
-  executeGroups(COM_PRIORITY_HIGH);
-  if (!this->getContext().isFastCalculation()) {
-    executeGroups(COM_PRIORITY_MEDIUM);
-    executeGroups(COM_PRIORITY_LOW);
+  if (this->m_context.getExecutionModel() == COM_EXECUTION_MODEL_FULL_FRAME) {
+    executeFullFrame();
+  }
+  else {
+    vector<ExecutionGroup *> executionGroups;
+    this->findOutputExecutionGroup(&executionGroups, COM_PRIORITY_HIGH);
+    if (!this->getContext().isFastCalculation()) {
+      this->findOutputExecutionGroup(&executionGroups, COM_PRIORITY_MEDIUM);
+      this->findOutputExecutionGroup(&executionGroups, COM_PRIORITY_LOW);
+    }
+    executeGroups(executionGroups);
   }
 
   WorkScheduler::finish();
   WorkScheduler::stop();
 
+  for (index = 0; index < this->m_operations.size(); index++) {
+    NodeOperation *operation = this->m_operations[index];
+    if (operation->isWriteBufferOperation()) {
+      storeCachedBuffer(((WriteBufferOperation *)operation)->getMemoryProxy());
+    }
+  }
+
   editingtree->stats_draw(editingtree->sdh, TIP_("Compositing | De-initializing execution"));
   for (index = 0; index < this->m_operations.size(); index++) {
     NodeOperation *operation = this->m_operations[index];
@@ -199,15 +225,157 @@ void ExecutionSystem::execute()
   }
 }
 
-void ExecutionSystem::executeGroups(CompositorPriority priority)
+void ExecutionSystem::executeGroups(const vector<ExecutionGroup *> &groups)
 {
+  const bNodeTree *bTree = this->m_context.getbNodeTree();
+  vector<ExecutionGroup *> running;
   unsigned int index;
-  vector<ExecutionGroup *> executionGroups;
-  this->findOutputExecutionGroup(&executionGroups, priority);
 
-  for (index = 0; index < executionGroups.size(); index++) {
-    ExecutionGroup *group = executionGroups[index];
-    group->execute(this);
+  for (index = 0; index < groups.size(); index++) {
+    if (groups[index]->beginExecution(this)) {
+      running.push_back(groups[index]);
+    }
+  }
+
+  /* Keep scheduling chunks of all groups as soon as any work finished, so the tail of one
+   * group doesn't leave the other threads idle. */
+  while (!running.empty()) {
+    for (index = 0; index < running.size();) {
+      ExecutionGroup *group = running[index];
+      if (group->scheduleNextChunks(this)) {
+        group->endExecution(this);
+        running.erase(running.begin() + index);
+      }
+      else {
+        index++;
+      }
+    }
+    if (running.empty()) {
+      break;
+    }
+
+    WorkScheduler::waitForProgress();
+
+    if (bTree->test_break && bTree->test_break(bTree->tbh)) {
+      for (index = 0; index < running.size(); index++) {
+        running[index]->endExecution(this);
+      }
+      break;
+    }
+  }
+}
+
+void ExecutionSystem::restoreCachedBuffers()
+{
+  if (this->m_context.isRendering()) {
+    /* The render result changed, cached buffers derived from it are outdated. */
+    BufferCache::clear();
+    return;
+  }
+
+  bool restored = false;
+  for (unsigned int index = 0; index < this->m_operations.size(); index++) {
+    NodeOperation *operation = this->m_operations[index];
+    if (!operation->isWriteBufferOperation()) {
+      continue;
+    }
+    MemoryProxy *memoryProxy = ((WriteBufferOperation *)operation)->getMemoryProxy();
+    if (memoryProxy->getCacheKey() == 0 || memoryProxy->getExecutor() == NULL) {
+      continue;
+    }
+    MemoryBuffer *buffer = BufferCache::take(memoryProxy->getCacheKey(),
+                                             memoryProxy->getBuffer());
+    if (buffer) {
+      memoryProxy->setBuffer(buffer);
+      memoryProxy->getExecutor()->markExecuted();
+      restored = true;
+    }
+  }
+
+  if (restored) {
+    for (unsigned int index = 0; index < this->m_operations.size(); index++) {
+      NodeOperation *operation = this->m_operations[index];
+      if (operation->isReadBufferOperation()) {
+        ((ReadBufferOperation *)operation)->updateMemoryBuffer();
+      }
+    }
+  }
+}
+
+bool ExecutionSystem::storeCachedBuffer(MemoryProxy *memoryProxy)
+{
+  const bNodeTree *bTree = this->m_context.getbNodeTree();
+  if (memoryProxy->getCacheKey() == 0 || memoryProxy->getBuffer() == NULL ||
+      memoryProxy->getExecutor() == NULL || !memoryProxy->getExecutor()->isExecuted()) {
+    return false;
+  }
+  /* Buffers of a cancelled execution may be incomplete. */
+  if (bTree->test_break && bTree->test_break(bTree->tbh)) {
+    return false;
+  }
+  BufferCache::put(memoryProxy->getCacheKey(), memoryProxy->releaseBuffer());
+  return true;
+}
+
+void ExecutionSystem::appendExecutionOrder(ExecutionGroup *group, Groups &order) const
+{
+  if (std::find(order.begin(), order.end(), group) != order.end()) {
+    return;
+  }
+  if (group->isExecuted()) {
+    /* Restored from the BufferCache, nothing it reads from is needed. */
+    return;
+  }
+  vector<MemoryProxy *> memoryProxies;
+  group->determineDependingMemoryProxies(&memoryProxies);
+  for (MemoryProxy *memoryProxy : memoryProxies) {
+    ExecutionGroup *executor = memoryProxy->getExecutor();
+    if (executor && executor != group) {
+      appendExecutionOrder(executor, order);
+    }
+  }
+  order.push_back(group);
+}
+
+void ExecutionSystem::executeFullFrame()
+{
+  const bNodeTree *bTree = this->m_context.getbNodeTree();
+
+  Groups outputGroups;
+  this->findOutputExecutionGroup(&outputGroups, COM_PRIORITY_HIGH);
+  if (!this->getContext().isFastCalculation()) {
+    this->findOutputExecutionGroup(&outputGroups, COM_PRIORITY_MEDIUM);
+    this->findOutputExecutionGroup(&outputGroups, COM_PRIORITY_LOW);
+  }
+
+  Groups order;
+  for (ExecutionGroup *group : outputGroups) {
+    appendExecutionOrder(group, order);
+  }
+
+  /* Count the remaining readers of each buffer, so it can be freed after its last use. */
+  std::map<MemoryProxy *, int> readers;
+  for (ExecutionGroup *group : order) {
+    vector<MemoryProxy *> memoryProxies;
+    group->determineDependingMemoryProxies(&memoryProxies);
+    for (MemoryProxy *memoryProxy : memoryProxies) {
+      readers[memoryProxy]++;
+    }
+  }
+
+  for (ExecutionGroup *group : order) {
+    if (bTree->test_break && bTree->test_break(bTree->tbh)) {
+      break;
+    }
+    group->executeFullFrame(this);
+
+    vector<MemoryProxy *> memoryProxies;
+    group->determineDependingMemoryProxies(&memoryProxies);
+    for (MemoryProxy *memoryProxy : memoryProxies) {
+      if (--readers[memoryProxy] == 0 && !storeCachedBuffer(memoryProxy)) {
+        memoryProxy->free();
+      }
+    }
   }
 }
 
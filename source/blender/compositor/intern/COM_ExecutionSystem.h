@@ -186,7 +186,35 @@ class ExecutionSystem {
   }
 
  private:
-  void executeGroups(CompositorPriority priority);
+  /**
+   * Execute the output groups concurrently, the chunks needed by higher priority outputs
+   * are executed first.
+   */
+  void executeGroups(const vector<ExecutionGroup *> &groups);
+
+  /**
+   * \brief execute the groups of the full frame execution model
+   * Groups are executed whole, after all groups they read from. The buffer of a MemoryProxy
+   * is freed as soon as the last group reading it has been executed.
+   */
+  void executeFullFrame();
+
+  /**
+   * \brief append \a group to \a order, after all groups it reads from (depth first)
+   */
+  void appendExecutionOrder(ExecutionGroup *group, Groups &order) const;
+
+  /**
+   * \brief use buffers of a previous execution from the BufferCache
+   * The ExecutionGroups writing these buffers are marked as executed.
+   */
+  void restoreCachedBuffers();
+
+  /**
+   * \brief move the buffer of \a memoryProxy to the BufferCache, when it can be cached
+   * \return whether the buffer was moved
+   */
+  bool storeCachedBuffer(MemoryProxy *memoryProxy);
 
   /* allow the DebugInfo class to look at internals */
   friend class DebugInfo;
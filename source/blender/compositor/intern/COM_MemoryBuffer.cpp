@@ -175,6 +175,18 @@ void MemoryBuffer::copyContentFrom(MemoryBuffer *otherBuffer)
   }
 }
 
+void MemoryBuffer::fill(const rcti *area, const float *value)
+{
+  const size_t pixel_size = sizeof(float) * this->m_num_channels;
+  for (int y = area->ymin; y < area->ymax; y++) {
+    float *out = this->getElem(area->xmin, y);
+    for (int x = area->xmin; x < area->xmax; x++) {
+      memcpy(out, value, pixel_size);
+      out += this->m_num_channels;
+    }
+  }
+}
+
 void MemoryBuffer::writePixel(int x, int y, const float color[4])
 {
   if (x >= this->m_rect.xmin && x < this->m_rect.xmax && y >= this->m_rect.ymin &&
@@ -123,6 +123,15 @@ class MemoryBuffer {
     return this->m_chunkNumber;
   }
 
+  /**
+   * \brief set the MemoryProxy this buffer belongs to, when it's moved between proxies
+   * \see BufferCache
+   */
+  void setMemoryProxy(MemoryProxy *memoryProxy)
+  {
+    this->m_memoryProxy = memoryProxy;
+  }
+
   unsigned int get_num_channels()
   {
     return this->m_num_channels;
@@ -137,6 +146,17 @@ class MemoryBuffer {
     return this->m_buffer;
   }
 
+  /**
+   * \brief get the data of the pixel at (x, y), which must be inside the rect of this buffer
+   */
+  float *getElem(int x, int y)
+  {
+    BLI_assert(x >= this->m_rect.xmin && x < this->m_rect.xmax && y >= this->m_rect.ymin &&
+               y < this->m_rect.ymax);
+    return &this->m_buffer[((y - this->m_rect.ymin) * this->m_width + (x - this->m_rect.xmin)) *
+                           this->m_num_channels];
+  }
+
   /**
    * \brief after execution the state will be set to available by calling this method
    */
@@ -275,6 +295,11 @@ class MemoryBuffer {
     memcpy(result, buffer, sizeof(float) * this->m_num_channels);
   }
 
+  /**
+   * \brief set all pixels of \a area to \a value, which has one float per channel
+   */
+  void fill(const rcti *area, const float *value);
+
   void writePixel(int x, int y, const float color[4]);
   void addPixel(int x, int y, const float color[4]);
   inline void readBilinear(float *result,
@@ -23,6 +23,8 @@ MemoryProxy::MemoryProxy(DataType datatype)
   this->m_writeBufferOperation = NULL;
   this->m_executor = NULL;
   this->m_datatype = datatype;
+  this->m_buffer = NULL;
+  this->m_cacheKey = 0;
 }
 
 void MemoryProxy::allocate(unsigned int width, unsigned int height)
@@ -43,3 +45,17 @@ void MemoryProxy::free()
     this->m_buffer = NULL;
   }
 }
+
+void MemoryProxy::setBuffer(MemoryBuffer *buffer)
+{
+  this->free();
+  buffer->setMemoryProxy(this);
+  this->m_buffer = buffer;
+}
+
+MemoryBuffer *MemoryProxy::releaseBuffer()
+{
+  MemoryBuffer *buffer = this->m_buffer;
+  this->m_buffer = NULL;
+  return buffer;
+}
@@ -64,6 +64,11 @@ class MemoryProxy {
    */
   DataType m_datatype;
 
+  /**
+   * \brief key of the buffer in the BufferCache, 0 when it can't be cached
+   */
+  uint64_t m_cacheKey;
+
  public:
   MemoryProxy(DataType type);
 
@@ -125,6 +130,26 @@ class MemoryProxy {
     return this->m_datatype;
   }
 
+  void setCacheKey(uint64_t cacheKey)
+  {
+    this->m_cacheKey = cacheKey;
+  }
+
+  uint64_t getCacheKey() const
+  {
+    return this->m_cacheKey;
+  }
+
+  /**
+   * \brief replace the allocated memory by \a buffer, which has the same size
+   */
+  void setBuffer(MemoryBuffer *buffer);
+
+  /**
+   * \brief give up ownership of the allocated memory
+   */
+  MemoryBuffer *releaseBuffer();
+
 #ifdef WITH_CXX_GUARDEDALLOC
   MEM_CXX_CLASS_ALLOC_FUNCS("COM:MemoryProxy")
 #endif
@@ -139,6 +139,32 @@ SocketReader *NodeOperation::getInputSocketReader(unsigned int inputSocketIndex)
   return this->getInputSocket(inputSocketIndex)->getReader();
 }
 
+void NodeOperation::executeArea(MemoryBuffer *output, const rcti *area)
+{
+  const int num_channels = output->get_num_channels();
+
+  for (int y = area->ymin; y < area->ymax; y++) {
+    float *out = output->getElem(area->xmin, y);
+    for (int x = area->xmin; x < area->xmax; x++) {
+      this->readSampled(out, x, y, COM_PS_NEAREST);
+      out += num_channels;
+    }
+    if (isBraked()) {
+      break;
+    }
+  }
+}
+
+MemoryBuffer *NodeOperation::createInputAreaBuffer(unsigned int inputSocketIndex,
+                                                   const rcti *area)
+{
+  NodeOperationInput *input = getInputSocket(inputSocketIndex);
+  rcti rect = *area;
+  MemoryBuffer *buffer = new MemoryBuffer(input->getDataType(), &rect);
+  getInputOperation(inputSocketIndex)->executeArea(buffer, area);
+  return buffer;
+}
+
 NodeOperation *NodeOperation::getInputOperation(unsigned int inputSocketIndex)
 {
   NodeOperationInput *input = getInputSocket(inputSocketIndex);
@@ -200,6 +200,19 @@ class NodeOperation : public SocketReader {
   {
   }
 
+  /**
+   * \brief calculate all pixels of an area at once, used by buffer writes of non-complex groups
+   * \ingroup execution
+   *
+   * The default implementation reads the pixels one by one (see #readSampled).
+   * Operations can override this to process whole rows without a virtual call per pixel,
+   * evaluating their inputs into buffers first (see #createInputAreaBuffer).
+   *
+   * \param output: buffer with the data type of the output socket, containing \a area
+   * \param area: the area to calculate, in image space
+   */
+  virtual void executeArea(MemoryBuffer *output, const rcti *area);
+
   /**
    * \brief when a chunk is executed by an OpenCLDevice, this method is called
    * \ingroup execution
@@ -396,6 +409,12 @@ class NodeOperation : public SocketReader {
   SocketReader *getInputSocketReader(unsigned int inputSocketindex);
   NodeOperation *getInputOperation(unsigned int inputSocketindex);
 
+  /**
+   * \brief calculate \a area of an input into a new temporary buffer, to be deleted by the caller
+   * \see executeArea
+   */
+  MemoryBuffer *createInputAreaBuffer(unsigned int inputSocketIndex, const rcti *area);
+
   void deinitMutex();
   void initMutex();
   void lockMutex();
@@ -16,8 +16,24 @@
  * Copyright 2013, Blender Foundation.
  */
 
+#include <string.h>
+#include <typeinfo>
+
+#include "MEM_guardedalloc.h"
+
 #include "BLI_utildefines.h"
 
+#include "DNA_ID.h"
+#include "DNA_color_types.h"
+#include "DNA_genfile.h"
+#include "DNA_node_types.h"
+#include "DNA_scene_types.h"
+
+#include "BKE_node.h"
+
+#include "RE_pipeline.h"
+
+#include "COM_BufferCache.h"
 #include "COM_Converter.h"
 #include "COM_Debug.h"
 #include "COM_ExecutionSystem.h"
@@ -38,7 +54,11 @@
 #include "COM_NodeOperationBuilder.h" /* own include */
 
 NodeOperationBuilder::NodeOperationBuilder(const CompositorContext *context, bNodeTree *b_nodetree)
-    : m_context(context), m_current_node(NULL), m_active_viewer(NULL)
+    : m_context(context),
+      m_current_node(NULL),
+      m_current_node_key(0),
+      m_current_node_operations(0),
+      m_active_viewer(NULL)
 {
   m_graph.from_bNodeTree(*context, b_nodetree);
 }
@@ -56,6 +76,8 @@ void NodeOperationBuilder::convertToOperations(ExecutionSystem *system)
     Node *node = (Node *)m_graph.nodes()[index];
 
     m_current_node = node;
+    m_current_node_key = node_cache_key(node);
+    m_current_node_operations = 0;
 
     DebugInfo::node_to_operations(node);
     node->convertToOperations(converter, *m_context);
@@ -119,6 +141,8 @@ void NodeOperationBuilder::convertToOperations(ExecutionSystem *system)
   /* create execution groups */
   group_operations();
 
+  determine_cache_keys();
+
   /* transfer resulting operations to the system */
   system->set_operations(m_operations, m_groups);
 }
@@ -126,6 +150,16 @@ void NodeOperationBuilder::convertToOperations(ExecutionSystem *system)
 void NodeOperationBuilder::addOperation(NodeOperation *operation)
 {
   m_operations.push_back(operation);
+
+  if (m_current_node) {
+    /* Operations of a node only differ by their creation order and the node settings. */
+    uint64_t key = m_current_node_key;
+    if (key != 0) {
+      key = BufferCache::hash(key, &m_current_node_operations, sizeof(m_current_node_operations));
+    }
+    m_operation_node_keys[operation] = key;
+    m_current_node_operations++;
+  }
 }
 
 void NodeOperationBuilder::mapInputSocket(NodeInput *node_socket,
@@ -735,3 +769,141 @@ void NodeOperationBuilder::group_operations()
     }
   }
 }
+
+uint64_t NodeOperationBuilder::node_cache_key(const Node *node) const
+{
+  uint64_t key = BufferCache::hash_init;
+  const bNode *b_node = node->getbNode();
+  if (b_node == NULL) {
+    return key;
+  }
+
+  /* Data-blocks like images, clips and masks can change without the node tree being updated. */
+  if (b_node->id && !ELEM(GS(b_node->id->name), ID_SCE, ID_NT)) {
+    return 0;
+  }
+  /* Pointers in the storage may point to other data with the same address after it was freed,
+   * so the bytes of such storage don't identify its settings. */
+  if (b_node->storage &&
+      (b_node->typeinfo->storagename[0] == '\0' ||
+       DNA_struct_has_pointers(DNA_sdna_current_get(), b_node->typeinfo->storagename))) {
+    return 0;
+  }
+
+  if (b_node->id) {
+    key = BufferCache::hash(key, b_node->id->name, strlen(b_node->id->name));
+    key = BufferCache::hash(key, &b_node->id->session_uuid, sizeof(b_node->id->session_uuid));
+  }
+  if (b_node->type == CMP_NODE_R_LAYERS) {
+    /* The render result can change without the compositor being executed, when rendering with
+     * compositing disabled for example. */
+    Render *re = (b_node->id) ? RE_GetSceneRender((Scene *)b_node->id) : NULL;
+    if (re) {
+      const RenderResult *rr = RE_AcquireResultRead(re);
+      const unsigned int update_id = (rr) ? rr->update_id : 0;
+      RE_ReleaseResult(re);
+      key = BufferCache::hash(key, &update_id, sizeof(update_id));
+    }
+  }
+  key = BufferCache::hash(key, &b_node->type, sizeof(b_node->type));
+  key = BufferCache::hash(key, &b_node->custom1, sizeof(b_node->custom1));
+  key = BufferCache::hash(key, &b_node->custom2, sizeof(b_node->custom2));
+  key = BufferCache::hash(key, &b_node->custom3, sizeof(b_node->custom3));
+  key = BufferCache::hash(key, &b_node->custom4, sizeof(b_node->custom4));
+  if (b_node->storage) {
+    key = BufferCache::hash(key, b_node->storage, MEM_allocN_len(b_node->storage));
+  }
+  for (const bNodeSocket *sock = (const bNodeSocket *)b_node->inputs.first; sock;
+       sock = sock->next) {
+    if (sock->default_value) {
+      key = BufferCache::hash(key, sock->default_value, MEM_allocN_len(sock->default_value));
+    }
+  }
+  return (key != 0) ? key : 1;
+}
+
+uint64_t NodeOperationBuilder::operation_cache_key(NodeOperation *op, OperationKeyMap &keys) const
+{
+  OperationKeyMap::const_iterator found = keys.find(op);
+  if (found != keys.end()) {
+    return found->second;
+  }
+
+  uint64_t key;
+  if (op->isReadBufferOperation()) {
+    MemoryProxy *memproxy = ((ReadBufferOperation *)op)->getMemoryProxy();
+    key = operation_cache_key(memproxy->getWriteBufferOperation(), keys);
+  }
+  else {
+    /* Operations added by the builder itself have no settings besides constant inputs. */
+    OperationKeyMap::const_iterator node_key = m_operation_node_keys.find(op);
+    key = (node_key != m_operation_node_keys.end()) ? node_key->second : BufferCache::hash_init;
+
+    if (key != 0) {
+      const char *type = typeid(*op).name();
+      const unsigned int resolution[2] = {op->getWidth(), op->getHeight()};
+      key = BufferCache::hash(key, type, strlen(type));
+      key = BufferCache::hash(key, resolution, sizeof(resolution));
+      if (op->isSetOperation()) {
+        float value[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        op->readSampled(value, 0, 0, COM_PS_NEAREST);
+        key = BufferCache::hash(key, value, sizeof(value));
+      }
+    }
+
+    for (unsigned int index = 0; key != 0 && index < op->getNumberOfInputSockets(); index++) {
+      NodeOperationOutput *link = op->getInputSocket(index)->getLink();
+      const uint64_t input_key = link ? operation_cache_key(&link->getOperation(), keys) : 0;
+      key = (input_key != 0) ? BufferCache::hash(key, &input_key, sizeof(input_key)) : 0;
+    }
+  }
+
+  keys[op] = key;
+  return key;
+}
+
+void NodeOperationBuilder::determine_cache_keys()
+{
+  /* Render results change on every render, don't keep buffers of them around. */
+  if (m_context->isRendering()) {
+    return;
+  }
+
+  /* Settings that are used by the conversion of many nodes. */
+  uint64_t context_key = BufferCache::hash_init;
+  const int framenumber = m_context->getFramenumber();
+  const CompositorQuality quality = m_context->getQuality();
+  const char *view_name = m_context->getViewName();
+  context_key = BufferCache::hash(context_key, &framenumber, sizeof(framenumber));
+  context_key = BufferCache::hash(context_key, &quality, sizeof(quality));
+  if (view_name) {
+    context_key = BufferCache::hash(context_key, view_name, strlen(view_name));
+  }
+  if (const ColorManagedViewSettings *view_settings = m_context->getViewSettings()) {
+    context_key = BufferCache::hash(context_key, view_settings->look, sizeof(view_settings->look));
+    context_key = BufferCache::hash(
+        context_key, view_settings->view_transform, sizeof(view_settings->view_transform));
+    context_key = BufferCache::hash(
+        context_key, &view_settings->exposure, sizeof(view_settings->exposure));
+    context_key = BufferCache::hash(
+        context_key, &view_settings->gamma, sizeof(view_settings->gamma));
+    context_key = BufferCache::hash(context_key, &view_settings->flag, sizeof(view_settings->flag));
+  }
+  if (const ColorManagedDisplaySettings *display_settings = m_context->getDisplaySettings()) {
+    context_key = BufferCache::hash(
+        context_key, display_settings->display_device, sizeof(display_settings->display_device));
+  }
+
+  OperationKeyMap keys;
+  for (Operations::const_iterator it = m_operations.begin(); it != m_operations.end(); ++it) {
+    NodeOperation *op = *it;
+    if (!op->isWriteBufferOperation()) {
+      continue;
+    }
+    uint64_t key = operation_cache_key(op, keys);
+    if (key != 0) {
+      key = BufferCache::hash(key, &context_key, sizeof(context_key));
+    }
+    ((WriteBufferOperation *)op)->getMemoryProxy()->setCacheKey(key);
+  }
+}
@@ -74,6 +74,8 @@ class NodeOperationBuilder {
   typedef std::vector<NodeOperationInput *> OpInputs;
   typedef std::map<NodeInput *, OpInputs> OpInputInverseMap;
 
+  typedef std::map<NodeOperation *, uint64_t> OperationKeyMap;
+
  private:
   const CompositorContext *m_context;
   NodeGraph m_graph;
@@ -88,6 +90,13 @@ class NodeOperationBuilder {
   OutputSocketMap m_output_map;
 
   Node *m_current_node;
+  /** Hash of the settings of the current node, see node_cache_key */
+  uint64_t m_current_node_key;
+  /** Number of operations added by the current node */
+  unsigned int m_current_node_operations;
+
+  /** Hash of the node settings each operation was created from, combined with its index */
+  OperationKeyMap m_operation_node_keys;
 
   /** Operation that will be writing to the viewer image
    *  Only one operation can occupy this place at a time,
@@ -168,6 +177,13 @@ class NodeOperationBuilder {
   void group_operations();
   ExecutionGroup *make_group(NodeOperation *op);
 
+  /** Hash of the settings of a node, 0 when its result can't be cached */
+  uint64_t node_cache_key(const Node *node) const;
+  /** Hash of an operation and everything it reads from, 0 when its result can't be cached */
+  uint64_t operation_cache_key(NodeOperation *op, OperationKeyMap &keys) const;
+  /** Set the keys of the memory proxies, used by the BufferCache */
+  void determine_cache_keys();
+
  private:
   PreviewOperation *make_preview_operation() const;
 
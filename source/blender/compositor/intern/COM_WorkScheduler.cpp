@@ -16,6 +16,7 @@
  * Copyright 2011, Blender Foundation.
  */
 
+#include <deque>
 #include <list>
 #include <stdio.h>
 
@@ -32,6 +33,8 @@
 #include "BLI_threads.h"
 #include "PIL_time.h"
 
+#include "atomic_ops.h"
+
 #include "BKE_global.h"
 
 #if COM_CURRENT_THREADING_MODEL == COM_TM_NOTHREAD
@@ -52,9 +55,29 @@ static ThreadLocal(CPUDevice *) g_thread_device;
 /// \brief list of all thread for every CPUDevice in cpudevices a thread exists
 static ListBase g_cputhreads;
 static bool g_cpuInitialized = false;
-/// \brief all scheduled work for the cpu
-static ThreadQueue *g_cpuqueue;
+/// \brief scheduled work of a single CPUDevice
+struct CPUWorkQueue {
+  SpinLock lock;
+  /// \brief indexed by CompositorPriority
+  std::deque<WorkPackage *> packages[COM_PRIORITY_HIGH + 1];
+};
+/// \brief all scheduled work for the cpu, a queue for every CPUDevice
+static vector<CPUWorkQueue *> g_cpuworkqueues;
+/// \brief number of packages in g_cpuworkqueues
+static int32_t g_cpuworkqueued;
 static ThreadQueue *g_gpuqueue;
+/// \brief protects the counters below and the conditions
+static ThreadMutex g_workmutex;
+/// \brief signaled when cpu work is added or the threads need to stop
+static ThreadCondition g_workcondition;
+/// \brief signaled when a work package has been executed
+static ThreadCondition g_progresscondition;
+/// \brief number of scheduled packages that have not been executed yet
+static int g_workpending;
+/// \brief number of executed packages, and the number seen by waitForProgress
+static unsigned int g_workfinished;
+static unsigned int g_workfinishedseen;
+static bool g_workstopping;
 #  ifdef COM_OPENCL_ENABLED
 static cl_context g_context;
 static cl_program g_program;
@@ -72,14 +95,101 @@ static bool g_openclInitialized = false;
 #endif
 
 #if COM_CURRENT_THREADING_MODEL == COM_TM_QUEUE
+static void work_pending_add()
+{
+  BLI_mutex_lock(&g_workmutex);
+  g_workpending++;
+  BLI_mutex_unlock(&g_workmutex);
+}
+
+static void work_package_finished()
+{
+  BLI_mutex_lock(&g_workmutex);
+  g_workpending--;
+  g_workfinished++;
+  BLI_condition_notify_all(&g_progresscondition);
+  BLI_mutex_unlock(&g_workmutex);
+}
+
+static void cpu_work_push(WorkPackage *package, CompositorPriority priority, unsigned int index)
+{
+  CPUWorkQueue *queue = g_cpuworkqueues[index];
+  work_pending_add();
+
+  BLI_spin_lock(&queue->lock);
+  queue->packages[priority].push_back(package);
+  BLI_spin_unlock(&queue->lock);
+
+  /* Counted under the mutex so a thread can't go to sleep between seeing no work and waiting. */
+  BLI_mutex_lock(&g_workmutex);
+  atomic_add_and_fetch_int32(&g_cpuworkqueued, 1);
+  BLI_condition_notify_one(&g_workcondition);
+  BLI_mutex_unlock(&g_workmutex);
+}
+
+/* The device takes its own work in scheduled order, others steal from the back. */
+static WorkPackage *cpu_work_try_take(unsigned int index)
+{
+  const unsigned int num_queues = g_cpuworkqueues.size();
+  for (int priority = COM_PRIORITY_HIGH; priority >= COM_PRIORITY_LOW; priority--) {
+    for (unsigned int offset = 0; offset < num_queues; offset++) {
+      CPUWorkQueue *queue = g_cpuworkqueues[(index + offset) % num_queues];
+      std::deque<WorkPackage *> &packages = queue->packages[priority];
+      WorkPackage *package = NULL;
+
+      BLI_spin_lock(&queue->lock);
+      if (!packages.empty()) {
+        if (offset == 0) {
+          package = packages.front();
+          packages.pop_front();
+        }
+        else {
+          package = packages.back();
+          packages.pop_back();
+        }
+      }
+      BLI_spin_unlock(&queue->lock);
+
+      if (package) {
+        atomic_sub_and_fetch_int32(&g_cpuworkqueued, 1);
+        return package;
+      }
+    }
+  }
+  return NULL;
+}
+
+/* Returns NULL when the threads are stopped and all work is taken. */
+static WorkPackage *cpu_work_take(unsigned int index)
+{
+  while (true) {
+    WorkPackage *package = cpu_work_try_take(index);
+    if (package) {
+      return package;
+    }
+
+    BLI_mutex_lock(&g_workmutex);
+    while (atomic_add_and_fetch_int32(&g_cpuworkqueued, 0) <= 0 && !g_workstopping) {
+      BLI_condition_wait(&g_workcondition, &g_workmutex);
+    }
+    const bool stop = atomic_add_and_fetch_int32(&g_cpuworkqueued, 0) <= 0;
+    BLI_mutex_unlock(&g_workmutex);
+
+    if (stop) {
+      return NULL;
+    }
+  }
+}
+
 void *WorkScheduler::thread_execute_cpu(void *data)
 {
   CPUDevice *device = (CPUDevice *)data;
   WorkPackage *work;
   BLI_thread_local_set(g_thread_device, device);
-  while ((work = (WorkPackage *)BLI_thread_queue_pop(g_cpuqueue))) {
+  while ((work = cpu_work_take(device->thread_id()))) {
     device->execute(work);
     delete work;
+    work_package_finished();
   }
 
   return NULL;
@@ -93,30 +203,33 @@ void *WorkScheduler::thread_execute_gpu(void *data)
   while ((work = (WorkPackage *)BLI_thread_queue_pop(g_gpuqueue))) {
     device->execute(work);
     delete work;
+    work_package_finished();
   }
 
   return NULL;
 }
 #endif
 
-void WorkScheduler::schedule(ExecutionGroup *group, int chunkNumber)
+void WorkScheduler::schedule(ExecutionGroup *group, int chunkNumber, CompositorPriority priority)
 {
   WorkPackage *package = new WorkPackage(group, chunkNumber);
 #if COM_CURRENT_THREADING_MODEL == COM_TM_NOTHREAD
+  (void)priority;
   CPUDevice device(0);
   device.execute(package);
   delete package;
 #elif COM_CURRENT_THREADING_MODEL == COM_TM_QUEUE
 #  ifdef COM_OPENCL_ENABLED
   if (group->isOpenCL() && g_openclActive) {
+    work_pending_add();
     BLI_thread_queue_push(g_gpuqueue, package);
+    return;
   }
-  else {
-    BLI_thread_queue_push(g_cpuqueue, package);
-  }
-#  else
-  BLI_thread_queue_push(g_cpuqueue, package);
 #  endif
+  /* Consecutive chunks (in rows) go to the same device. */
+  const unsigned int index = (unsigned int)(((uint64_t)chunkNumber * g_cpuworkqueues.size()) /
+                                            max(group->getNumberOfChunks(), 1u));
+  cpu_work_push(package, priority, min(index, (unsigned int)g_cpuworkqueues.size() - 1));
 #endif
 }
 
@@ -124,7 +237,19 @@ void WorkScheduler::start(CompositorContext &context)
 {
 #if COM_CURRENT_THREADING_MODEL == COM_TM_QUEUE
   unsigned int index;
-  g_cpuqueue = BLI_thread_queue_init();
+  BLI_mutex_init(&g_workmutex);
+  BLI_condition_init(&g_workcondition);
+  BLI_condition_init(&g_progresscondition);
+  g_workpending = 0;
+  g_workfinished = 0;
+  g_workfinishedseen = 0;
+  g_workstopping = false;
+  g_cpuworkqueued = 0;
+  for (index = 0; index < g_cpudevices.size(); index++) {
+    CPUWorkQueue *queue = new CPUWorkQueue();
+    BLI_spin_init(&queue->lock);
+    g_cpuworkqueues.push_back(queue);
+  }
   BLI_threadpool_init(&g_cputhreads, thread_execute_cpu, g_cpudevices.size());
   for (index = 0; index < g_cpudevices.size(); index++) {
     Device *device = g_cpudevices[index];
@@ -149,26 +274,39 @@ void WorkScheduler::start(CompositorContext &context)
 void WorkScheduler::finish()
 {
 #if COM_CURRENT_THREADING_MODEL == COM_TM_QUEUE
-#  ifdef COM_OPENCL_ENABLED
-  if (g_openclActive) {
-    BLI_thread_queue_wait_finish(g_gpuqueue);
-    BLI_thread_queue_wait_finish(g_cpuqueue);
+  BLI_mutex_lock(&g_workmutex);
+  while (g_workpending > 0) {
+    BLI_condition_wait(&g_progresscondition, &g_workmutex);
   }
-  else {
-    BLI_thread_queue_wait_finish(g_cpuqueue);
+  g_workfinishedseen = g_workfinished;
+  BLI_mutex_unlock(&g_workmutex);
+#endif
+}
+void WorkScheduler::waitForProgress()
+{
+#if COM_CURRENT_THREADING_MODEL == COM_TM_QUEUE
+  BLI_mutex_lock(&g_workmutex);
+  while (g_workpending > 0 && g_workfinished == g_workfinishedseen) {
+    BLI_condition_wait(&g_progresscondition, &g_workmutex);
   }
-#  else
-  BLI_thread_queue_wait_finish(cpuqueue);
-#  endif
+  g_workfinishedseen = g_workfinished;
+  BLI_mutex_unlock(&g_workmutex);
 #endif
 }
 void WorkScheduler::stop()
 {
 #if COM_CURRENT_THREADING_MODEL == COM_TM_QUEUE
-  BLI_thread_queue_nowait(g_cpuqueue);
+  BLI_mutex_lock(&g_workmutex);
+  g_workstopping = true;
+  BLI_condition_notify_all(&g_workcondition);
+  BLI_mutex_unlock(&g_workmutex);
   BLI_threadpool_end(&g_cputhreads);
-  BLI_thread_queue_free(g_cpuqueue);
-  g_cpuqueue = NULL;
+  while (!g_cpuworkqueues.empty()) {
+    CPUWorkQueue *queue = g_cpuworkqueues.back();
+    g_cpuworkqueues.pop_back();
+    BLI_spin_end(&queue->lock);
+    delete queue;
+  }
 #  ifdef COM_OPENCL_ENABLED
   if (g_openclActive) {
     BLI_thread_queue_nowait(g_gpuqueue);
@@ -177,6 +315,9 @@ void WorkScheduler::stop()
     g_gpuqueue = NULL;
   }
 #  endif
+  BLI_condition_end(&g_progresscondition);
+  BLI_condition_end(&g_workcondition);
+  BLI_mutex_end(&g_workmutex);
 #endif
 }
 
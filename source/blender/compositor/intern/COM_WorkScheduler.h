@@ -55,11 +55,17 @@ class WorkScheduler {
    * An execution group schedules a chunk in the WorkScheduler
    * when ExecutionGroup.isOpenCL is set the work will be handled by a OpenCLDevice
    * otherwise the work is scheduled for an CPUDevice
+   *
+   * Every CPUDevice has its own queue of work per priority. A chunk is queued on the device
+   * that gets the same part of the image for every group, so chunks reading the result of
+   * another group tend to run on the thread that calculated it. Idle devices steal work from
+   * the others, higher priority work first.
    * \see ExecutionGroup.execute
    * \param group: the execution group
    * \param chunkNumber: the number of the chunk in the group to be executed
+   * \param priority: priority of the output that needs this chunk
    */
-  static void schedule(ExecutionGroup *group, int chunkNumber);
+  static void schedule(ExecutionGroup *group, int chunkNumber, CompositorPriority priority);
 
   /**
    * \brief initialize the WorkScheduler
@@ -101,6 +107,13 @@ class WorkScheduler {
    */
   static void finish();
 
+  /**
+   * \brief wait until a work package has been completed since the previous call,
+   * or until there is no work left.
+   * Used to schedule more work as soon as a device is available.
+   */
+  static void waitForProgress();
+
   /**
    * \brief Are there OpenCL capable GPU devices initialized?
    * the result of this method is stored in the CompositorContext
@@ -29,6 +29,10 @@
 #include "COM_SetValueOperation.h"
 #include "DNA_node_types.h"
 
+/* Radius in pixels from which a constant size gaussian blur is done with the recursive
+ * filter of the Fast Gaussian type, whose cost does not depend on the radius. */
+#define COM_BLUR_RECURSIVE_GAUSS_MIN_RADIUS 64.0f
+
 BlurNode::BlurNode(bNode *editorNode) : Node(editorNode)
 {
   /* pass */
@@ -48,7 +52,30 @@ void BlurNode::convertToOperations(NodeConverter &converter,
   CompositorQuality quality = context.getQuality();
   NodeOperation *input_operation = NULL, *output_operation = NULL;
 
-  if (data->filtertype == R_FILTER_FAST_GAUSS) {
+  /* The separable gaussian costs a kernel tap per pixel of radius, past a certain size the
+   * recursive filter is faster and visually the same. Only possible when the size is known
+   * now, a linked size socket or relative size is only resolved during execution. */
+  const bool use_recursive_gauss = data->filtertype == R_FILTER_GAUSS && !data->bokeh &&
+                                   !data->relative && !connectedSizeSocket &&
+                                   !(editorNode->custom1 & CMP_NODEFLAG_BLUR_VARIABLE_SIZE) &&
+                                   max_ii(data->sizex, data->sizey) * size >=
+                                       COM_BLUR_RECURSIVE_GAUSS_MIN_RADIUS;
+
+  if (use_recursive_gauss) {
+    FastGaussianBlurOperation *operationfgb = new FastGaussianBlurOperation();
+    operationfgb->setData(data);
+    operationfgb->setExtendBounds(extend_bounds);
+    /* The gaussian filter kernel falls off at a third of the radius. */
+    operationfgb->setSigmaScale(1.0f / 3.0f);
+    operationfgb->setSize(size);
+    converter.addOperation(operationfgb);
+
+    converter.mapInputSocket(getInputSocket(1), operationfgb->getInputSocket(1));
+
+    input_operation = operationfgb;
+    output_operation = operationfgb;
+  }
+  else if (data->filtertype == R_FILTER_FAST_GAUSS) {
     FastGaussianBlurOperation *operationfgb = new FastGaussianBlurOperation();
     operationfgb->setData(data);
     operationfgb->setExtendBounds(extend_bounds);
@@ -18,10 +18,15 @@
 
 #include "COM_BokehBlurOperation.h"
 #include "BLI_math.h"
+#include "COM_GlareFogGlowOperation.h"
 #include "COM_OpenCLDevice.h"
 
 #include "RE_pipeline.h"
 
+/* Radius in pixels from which a blur of known size is done with a FFT convolution,
+ * the gather loop costs a bokeh sample per pixel in the kernel area. */
+#define COM_BOKEH_BLUR_FFT_MIN_RADIUS 32
+
 BokehBlurOperation::BokehBlurOperation() : NodeOperation()
 {
   this->addInputSocket(COM_DT_COLOR);
@@ -39,6 +44,8 @@ BokehBlurOperation::BokehBlurOperation() : NodeOperation()
   this->m_inputBoundingBoxReader = NULL;
 
   this->m_extend_bounds = false;
+  this->m_useFFT = false;
+  this->m_fftResult = NULL;
 }
 
 void *BokehBlurOperation::initializeTileData(rcti * /*rect*/)
@@ -48,10 +55,68 @@ void *BokehBlurOperation::initializeTileData(rcti * /*rect*/)
     updateSize();
   }
   void *buffer = getInputOperation(0)->initializeTileData(NULL);
+  if (this->m_useFFT) {
+    if (!this->m_fftResult) {
+      this->m_fftResult = createFFTResult((MemoryBuffer *)buffer);
+    }
+    buffer = this->m_fftResult;
+  }
   unlockMutex();
   return buffer;
 }
 
+MemoryBuffer *BokehBlurOperation::createFFTResult(MemoryBuffer *input)
+{
+  const float max_dim = max(this->getWidth(), this->getHeight());
+  const int pixelSize = this->m_size * max_dim / 100.0f;
+  const int kernelSize = 2 * pixelSize + 1;
+  const float m = this->m_bokehDimension / pixelSize;
+
+  /* Mirrored kernel centered on pixelSize, the gather loop in #executePixel samples
+   * offsets from -pixelSize up to (not including) pixelSize. */
+  rcti kernelRect;
+  BLI_rcti_init(&kernelRect, 0, kernelSize, 0, kernelSize);
+  MemoryBuffer *kernel = new MemoryBuffer(COM_DT_COLOR, &kernelRect);
+  float *kernelBuffer = kernel->getBuffer();
+  for (int j = 0; j < kernelSize; j++) {
+    const int dy = pixelSize - j;
+    for (int i = 0; i < kernelSize; i++) {
+      const int dx = pixelSize - i;
+      float *elem = &kernelBuffer[(j * kernelSize + i) * COM_NUM_CHANNELS_COLOR];
+      if (dx == pixelSize || dy == pixelSize) {
+        zero_v4(elem);
+      }
+      else {
+        const float u = this->m_bokehMidX - dx * m;
+        const float v = this->m_bokehMidY - dy * m;
+        this->m_inputBokehProgram->readSampled(elem, u, v, COM_PS_NEAREST);
+      }
+    }
+  }
+
+  MemoryBuffer *result = new MemoryBuffer(COM_DT_COLOR, input->getRect());
+  GlareFogGlowOperation::convolve(result->getBuffer(), input, kernel, COM_NUM_CHANNELS_COLOR);
+
+  /* Like the gather loop, only weight the samples inside the image: convolving a constant
+   * image gives the kernel weight covered by the image at each pixel. */
+  MemoryBuffer *weights = new MemoryBuffer(COM_DT_COLOR, input->getRect());
+  const float one[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+  weights->fill(input->getRect(), one);
+  GlareFogGlowOperation::convolve(weights->getBuffer(), weights, kernel, COM_NUM_CHANNELS_COLOR);
+
+  float *resultBuffer = result->getBuffer();
+  const float *weightBuffer = weights->getBuffer();
+  const size_t numFloats = (size_t)result->getWidth() * result->getHeight() *
+                           COM_NUM_CHANNELS_COLOR;
+  for (size_t i = 0; i < numFloats; i++) {
+    resultBuffer[i] = (weightBuffer[i] != 0.0f) ? resultBuffer[i] / weightBuffer[i] : 0.0f;
+  }
+
+  delete weights;
+  delete kernel;
+  return result;
+}
+
 void BokehBlurOperation::initExecution()
 {
   initMutex();
@@ -68,6 +133,12 @@ void BokehBlurOperation::initExecution()
   this->m_bokehMidY = height / 2.0f;
   this->m_bokehDimension = dimension / 2.0f;
   QualityStepHelper::initExecution(COM_QH_INCREASE);
+
+  /* Only when the size is known up front, otherwise the area of interest is not the whole
+   * input. */
+  const float max_dim = max(this->getWidth(), this->getHeight());
+  this->m_useFFT = this->m_sizeavailable &&
+                   (int)(this->m_size * max_dim / 100.0f) >= COM_BOKEH_BLUR_FFT_MIN_RADIUS;
 }
 
 void BokehBlurOperation::executePixel(float output[4], int x, int y, void *data)
@@ -77,7 +148,10 @@ void BokehBlurOperation::executePixel(float output[4], int x, int y, void *data)
   float bokeh[4];
 
   this->m_inputBoundingBoxReader->readSampled(tempBoundingBox, x, y, COM_PS_NEAREST);
-  if (tempBoundingBox[0] > 0.0f) {
+  if (tempBoundingBox[0] > 0.0f && this->m_useFFT) {
+    ((MemoryBuffer *)data)->read(output, x, y);
+  }
+  else if (tempBoundingBox[0] > 0.0f) {
     float multiplier_accum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
     MemoryBuffer *inputBuffer = (MemoryBuffer *)data;
     float *buffer = inputBuffer->getBuffer();
@@ -132,6 +206,10 @@ void BokehBlurOperation::executePixel(float output[4], int x, int y, void *data)
 
 void BokehBlurOperation::deinitExecution()
 {
+  if (this->m_fftResult) {
+    delete this->m_fftResult;
+    this->m_fftResult = NULL;
+  }
   deinitMutex();
   this->m_inputProgram = NULL;
   this->m_inputBokehProgram = NULL;
@@ -146,7 +224,14 @@ bool BokehBlurOperation::determineDependingAreaOfInterest(rcti *input,
   rcti bokehInput;
   const float max_dim = max(this->getWidth(), this->getHeight());
 
-  if (this->m_sizeavailable) {
+  if (this->m_useFFT) {
+    NodeOperation *inputOperation = getInputOperation(0);
+    newInput.xmin = 0;
+    newInput.xmax = inputOperation->getWidth();
+    newInput.ymin = 0;
+    newInput.ymax = inputOperation->getHeight();
+  }
+  else if (this->m_sizeavailable) {
     newInput.xmax = input->xmax + (this->m_size * max_dim / 100.0f);
     newInput.xmin = input->xmin - (this->m_size * max_dim / 100.0f);
     newInput.ymax = input->ymax + (this->m_size * max_dim / 100.0f);
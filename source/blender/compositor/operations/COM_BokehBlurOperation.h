@@ -34,6 +34,11 @@ class BokehBlurOperation : public NodeOperation, public QualityStepHelper {
   float m_bokehDimension;
   bool m_extend_bounds;
 
+  /* Large constant size blurs are done at once with a FFT convolution of the whole input. */
+  bool m_useFFT;
+  MemoryBuffer *m_fftResult;
+  MemoryBuffer *createFFTResult(MemoryBuffer *input);
+
  public:
   BokehBlurOperation();
 
@@ -54,6 +54,14 @@ void ConvertValueToColorOperation::executePixelSampled(float output[4],
   output[3] = 1.0f;
 }
 
+void ConvertValueToColorOperation::executeArea(MemoryBuffer *output, const rcti *area)
+{
+  convertArea(output, area, [](float *out, const float *in) {
+    out[0] = out[1] = out[2] = in[0];
+    out[3] = 1.0f;
+  });
+}
+
 /* ******** Color to Value ******** */
 
 ConvertColorToValueOperation::ConvertColorToValueOperation() : ConvertBaseOperation()
@@ -72,6 +80,13 @@ void ConvertColorToValueOperation::executePixelSampled(float output[4],
   output[0] = (inputColor[0] + inputColor[1] + inputColor[2]) / 3.0f;
 }
 
+void ConvertColorToValueOperation::executeArea(MemoryBuffer *output, const rcti *area)
+{
+  convertArea(output, area, [](float *out, const float *in) {
+    out[0] = (in[0] + in[1] + in[2]) / 3.0f;
+  });
+}
+
 /* ******** Color to BW ******** */
 
 ConvertColorToBWOperation::ConvertColorToBWOperation() : ConvertBaseOperation()
@@ -90,6 +105,13 @@ void ConvertColorToBWOperation::executePixelSampled(float output[4],
   output[0] = IMB_colormanagement_get_luminance(inputColor);
 }
 
+void ConvertColorToBWOperation::executeArea(MemoryBuffer *output, const rcti *area)
+{
+  convertArea(output, area, [](float *out, const float *in) {
+    out[0] = IMB_colormanagement_get_luminance(in);
+  });
+}
+
 /* ******** Color to Vector ******** */
 
 ConvertColorToVectorOperation::ConvertColorToVectorOperation() : ConvertBaseOperation()
@@ -108,6 +130,13 @@ void ConvertColorToVectorOperation::executePixelSampled(float output[4],
   copy_v3_v3(output, color);
 }
 
+void ConvertColorToVectorOperation::executeArea(MemoryBuffer *output, const rcti *area)
+{
+  convertArea(output, area, [](float *out, const float *in) {
+    copy_v3_v3(out, in);
+  });
+}
+
 /* ******** Value to Vector ******** */
 
 ConvertValueToVectorOperation::ConvertValueToVectorOperation() : ConvertBaseOperation()
@@ -126,6 +155,13 @@ void ConvertValueToVectorOperation::executePixelSampled(float output[4],
   output[0] = output[1] = output[2] = value;
 }
 
+void ConvertValueToVectorOperation::executeArea(MemoryBuffer *output, const rcti *area)
+{
+  convertArea(output, area, [](float *out, const float *in) {
+    out[0] = out[1] = out[2] = in[0];
+  });
+}
+
 /* ******** Vector to Color ******** */
 
 ConvertVectorToColorOperation::ConvertVectorToColorOperation() : ConvertBaseOperation()
@@ -143,6 +179,14 @@ void ConvertVectorToColorOperation::executePixelSampled(float output[4],
   output[3] = 1.0f;
 }
 
+void ConvertVectorToColorOperation::executeArea(MemoryBuffer *output, const rcti *area)
+{
+  convertArea(output, area, [](float *out, const float *in) {
+    copy_v3_v3(out, in);
+    out[3] = 1.0f;
+  });
+}
+
 /* ******** Vector to Value ******** */
 
 ConvertVectorToValueOperation::ConvertVectorToValueOperation() : ConvertBaseOperation()
@@ -161,6 +205,13 @@ void ConvertVectorToValueOperation::executePixelSampled(float output[4],
   output[0] = (input[0] + input[1] + input[2]) / 3.0f;
 }
 
+void ConvertVectorToValueOperation::executeArea(MemoryBuffer *output, const rcti *area)
+{
+  convertArea(output, area, [](float *out, const float *in) {
+    out[0] = (in[0] + in[1] + in[2]) / 3.0f;
+  });
+}
+
 /* ******** RGB to YCC ******** */
 
 ConvertRGBToYCCOperation::ConvertRGBToYCCOperation() : ConvertBaseOperation()
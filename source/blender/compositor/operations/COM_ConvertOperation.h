@@ -18,12 +18,35 @@
 
 #pragma once
 
+#include "COM_MemoryBuffer.h"
 #include "COM_NodeOperation.h"
 
 class ConvertBaseOperation : public NodeOperation {
  protected:
   SocketReader *m_inputOperation;
 
+  /**
+   * Calculate \a area of the input into a buffer and convert it pixel by pixel,
+   * \a convert is called as `convert(float *out, const float *in)`.
+   */
+  template<typename ConvertFunc>
+  void convertArea(MemoryBuffer *output, const rcti *area, const ConvertFunc &convert)
+  {
+    MemoryBuffer *input = this->createInputAreaBuffer(0, area);
+    const int in_channels = input->get_num_channels();
+    const int out_channels = output->get_num_channels();
+    for (int y = area->ymin; y < area->ymax; y++) {
+      const float *in = input->getElem(area->xmin, y);
+      float *out = output->getElem(area->xmin, y);
+      for (int x = area->xmin; x < area->xmax; x++) {
+        convert(out, in);
+        in += in_channels;
+        out += out_channels;
+      }
+    }
+    delete input;
+  }
+
  public:
   ConvertBaseOperation();
 
@@ -36,6 +59,7 @@ class ConvertValueToColorOperation : public ConvertBaseOperation {
   ConvertValueToColorOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, const rcti *area);
 };
 
 class ConvertColorToValueOperation : public ConvertBaseOperation {
@@ -43,6 +67,7 @@ class ConvertColorToValueOperation : public ConvertBaseOperation {
   ConvertColorToValueOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, const rcti *area);
 };
 
 class ConvertColorToBWOperation : public ConvertBaseOperation {
@@ -50,6 +75,7 @@ class ConvertColorToBWOperation : public ConvertBaseOperation {
   ConvertColorToBWOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, const rcti *area);
 };
 
 class ConvertColorToVectorOperation : public ConvertBaseOperation {
@@ -57,6 +83,7 @@ class ConvertColorToVectorOperation : public ConvertBaseOperation {
   ConvertColorToVectorOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, const rcti *area);
 };
 
 class ConvertValueToVectorOperation : public ConvertBaseOperation {
@@ -64,6 +91,7 @@ class ConvertValueToVectorOperation : public ConvertBaseOperation {
   ConvertValueToVectorOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, const rcti *area);
 };
 
 class ConvertVectorToColorOperation : public ConvertBaseOperation {
@@ -71,6 +99,7 @@ class ConvertVectorToColorOperation : public ConvertBaseOperation {
   ConvertVectorToColorOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, const rcti *area);
 };
 
 class ConvertVectorToValueOperation : public ConvertBaseOperation {
@@ -78,6 +107,7 @@ class ConvertVectorToValueOperation : public ConvertBaseOperation {
   ConvertVectorToValueOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, const rcti *area);
 };
 
 class ConvertRGBToYCCOperation : public ConvertBaseOperation {
@@ -18,6 +18,7 @@
 
 #include <limits.h>
 
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 #include "COM_FastGaussianBlurOperation.h"
 #include "MEM_guardedalloc.h"
@@ -25,6 +26,7 @@
 FastGaussianBlurOperation::FastGaussianBlurOperation() : BlurBaseOperation(COM_DT_COLOR)
 {
   this->m_iirgaus = NULL;
+  this->m_sigmaScale = 0.5f;
 }
 
 void FastGaussianBlurOperation::executePixel(float output[4], int x, int y, void *data)
@@ -84,8 +86,8 @@ void *FastGaussianBlurOperation::initializeTileData(rcti *rect)
     updateSize();
 
     int c;
-    this->m_sx = this->m_data.sizex * this->m_size / 2.0f;
-    this->m_sy = this->m_data.sizey * this->m_size / 2.0f;
+    this->m_sx = this->m_data.sizex * this->m_size * this->m_sigmaScale;
+    this->m_sy = this->m_data.sizey * this->m_size * this->m_sigmaScale;
 
     if ((this->m_sx == this->m_sy) && (this->m_sx > 0.0f)) {
       for (c = 0; c < COM_NUM_CHANNELS_COLOR; c++) {
@@ -110,17 +112,118 @@ void *FastGaussianBlurOperation::initializeTileData(rcti *rect)
   return this->m_iirgaus;
 }
 
+/* Recursive filter coefficients shared by all lines of one #IIR_gauss call. */
+struct IIRGaussCoefficients {
+  double cf[4];
+  double tsM[9];
+};
+
+/* Forward and backward recursive passes over one line of \a L samples, \a X to \a Y. */
+static void IIR_gauss_line(const IIRGaussCoefficients *coefs,
+                           const double *X,
+                           double *Y,
+                           double *W,
+                           const unsigned int L)
+{
+  const double *cf = coefs->cf;
+  const double *tsM = coefs->tsM;
+  double tsu[3], tsv[3];
+  unsigned int i;
+
+  W[0] = cf[0] * X[0] + cf[1] * X[0] + cf[2] * X[0] + cf[3] * X[0];
+  W[1] = cf[0] * X[1] + cf[1] * W[0] + cf[2] * X[0] + cf[3] * X[0];
+  W[2] = cf[0] * X[2] + cf[1] * W[1] + cf[2] * W[0] + cf[3] * X[0];
+  for (i = 3; i < L; i++) {
+    W[i] = cf[0] * X[i] + cf[1] * W[i - 1] + cf[2] * W[i - 2] + cf[3] * W[i - 3];
+  }
+  tsu[0] = W[L - 1] - X[L - 1];
+  tsu[1] = W[L - 2] - X[L - 1];
+  tsu[2] = W[L - 3] - X[L - 1];
+  tsv[0] = tsM[0] * tsu[0] + tsM[1] * tsu[1] + tsM[2] * tsu[2] + X[L - 1];
+  tsv[1] = tsM[3] * tsu[0] + tsM[4] * tsu[1] + tsM[5] * tsu[2] + X[L - 1];
+  tsv[2] = tsM[6] * tsu[0] + tsM[7] * tsu[1] + tsM[8] * tsu[2] + X[L - 1];
+  Y[L - 1] = cf[0] * W[L - 1] + cf[1] * tsv[0] + cf[2] * tsv[1] + cf[3] * tsv[2];
+  Y[L - 2] = cf[0] * W[L - 2] + cf[1] * Y[L - 1] + cf[2] * tsv[0] + cf[3] * tsv[1];
+  Y[L - 3] = cf[0] * W[L - 3] + cf[1] * Y[L - 2] + cf[2] * Y[L - 1] + cf[3] * tsv[0];
+  /* 'i != UINT_MAX' is really 'i >= 0', but necessary for unsigned int wrapping */
+  for (i = L - 4; i != UINT_MAX; i--) {
+    Y[i] = cf[0] * W[i] + cf[1] * Y[i + 1] + cf[2] * Y[i + 2] + cf[3] * Y[i + 3];
+  }
+}
+
+struct IIRGaussData {
+  const IIRGaussCoefficients *coefs;
+  float *buffer;
+  /* Number of samples per line. */
+  unsigned int length;
+  /* Offset of the first sample of line N is N * line_stride, of sample I within a line
+   * I * sample_stride (both in floats, channel offset included in buffer). */
+  unsigned int line_stride;
+  unsigned int sample_stride;
+};
+
+/* Per thread scratch lines, allocated on first use. */
+struct IIRGaussChunk {
+  double *X, *Y, *W;
+};
+
+static void IIR_gauss_line_task(void *__restrict userdata,
+                                const int line,
+                                const TaskParallelTLS *__restrict tls)
+{
+  const IIRGaussData *data = (const IIRGaussData *)userdata;
+  IIRGaussChunk *chunk = (IIRGaussChunk *)tls->userdata_chunk;
+  const unsigned int length = data->length;
+  const unsigned int stride = data->sample_stride;
+  unsigned int i;
+
+  if (chunk->X == NULL) {
+    chunk->X = (double *)MEM_mallocN(length * sizeof(double), "IIR_gauss X buf");
+    chunk->Y = (double *)MEM_mallocN(length * sizeof(double), "IIR_gauss Y buf");
+    chunk->W = (double *)MEM_mallocN(length * sizeof(double), "IIR_gauss W buf");
+  }
+
+  float *buffer = data->buffer + (size_t)line * data->line_stride;
+  for (i = 0; i < length; i++) {
+    chunk->X[i] = buffer[i * stride];
+  }
+  IIR_gauss_line(data->coefs, chunk->X, chunk->Y, chunk->W, length);
+  for (i = 0; i < length; i++) {
+    buffer[i * stride] = chunk->Y[i];
+  }
+}
+
+static void IIR_gauss_line_free(const void *__restrict /*userdata*/, void *__restrict chunk_v)
+{
+  IIRGaussChunk *chunk = (IIRGaussChunk *)chunk_v;
+  MEM_SAFE_FREE(chunk->X);
+  MEM_SAFE_FREE(chunk->Y);
+  MEM_SAFE_FREE(chunk->W);
+}
+
+/* Filter \a num_lines independent lines, spread over threads. */
+static void IIR_gauss_lines(IIRGaussData *data, const unsigned int num_lines)
+{
+  IIRGaussChunk chunk = {NULL, NULL, NULL};
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.userdata_chunk = &chunk;
+  settings.userdata_chunk_size = sizeof(chunk);
+  settings.func_free = IIR_gauss_line_free;
+  BLI_task_parallel_range(0, num_lines, data, IIR_gauss_line_task, &settings);
+}
+
 void FastGaussianBlurOperation::IIR_gauss(MemoryBuffer *src,
                                           float sigma,
                                           unsigned int chan,
                                           unsigned int xy)
 {
-  double q, q2, sc, cf[4], tsM[9], tsu[3], tsv[3];
-  double *X, *Y, *W;
+  double q, q2, sc;
+  IIRGaussCoefficients coefs;
+  double *cf = coefs.cf;
+  double *tsM = coefs.tsM;
   const unsigned int src_width = src->getWidth();
   const unsigned int src_height = src->getHeight();
-  unsigned int x, y, sz;
-  unsigned int i;
   float *buffer = src->getBuffer();
   const unsigned int num_channels = src->get_num_channels();
 
@@ -133,7 +236,7 @@ void FastGaussianBlurOperation::IIR_gauss(MemoryBuffer *src,
     xy = 3;
   }
 
-  // XXX The YVV macro defined below explicitly expects sources of at least 3x3 pixels,
+  // XXX The line filter explicitly expects sources of at least 3x3 pixels,
   //     so just skipping blur along faulty direction if src's def is below that limit!
   if (src_width < 3) {
     xy &= ~1;
@@ -184,75 +287,22 @@ void FastGaussianBlurOperation::IIR_gauss(MemoryBuffer *src,
                  cf[3] * cf[3] * cf[3] - cf[3] * cf[2] + cf[3]);
   tsM[8] = sc * (cf[3] * (cf[1] + cf[3] * cf[2]));
 
-#define YVV(L) \
-  { \
-    W[0] = cf[0] * X[0] + cf[1] * X[0] + cf[2] * X[0] + cf[3] * X[0]; \
-    W[1] = cf[0] * X[1] + cf[1] * W[0] + cf[2] * X[0] + cf[3] * X[0]; \
-    W[2] = cf[0] * X[2] + cf[1] * W[1] + cf[2] * W[0] + cf[3] * X[0]; \
-    for (i = 3; i < L; i++) { \
-      W[i] = cf[0] * X[i] + cf[1] * W[i - 1] + cf[2] * W[i - 2] + cf[3] * W[i - 3]; \
-    } \
-    tsu[0] = W[L - 1] - X[L - 1]; \
-    tsu[1] = W[L - 2] - X[L - 1]; \
-    tsu[2] = W[L - 3] - X[L - 1]; \
-    tsv[0] = tsM[0] * tsu[0] + tsM[1] * tsu[1] + tsM[2] * tsu[2] + X[L - 1]; \
-    tsv[1] = tsM[3] * tsu[0] + tsM[4] * tsu[1] + tsM[5] * tsu[2] + X[L - 1]; \
-    tsv[2] = tsM[6] * tsu[0] + tsM[7] * tsu[1] + tsM[8] * tsu[2] + X[L - 1]; \
-    Y[L - 1] = cf[0] * W[L - 1] + cf[1] * tsv[0] + cf[2] * tsv[1] + cf[3] * tsv[2]; \
-    Y[L - 2] = cf[0] * W[L - 2] + cf[1] * Y[L - 1] + cf[2] * tsv[0] + cf[3] * tsv[1]; \
-    Y[L - 3] = cf[0] * W[L - 3] + cf[1] * Y[L - 2] + cf[2] * Y[L - 1] + cf[3] * tsv[0]; \
-    /* 'i != UINT_MAX' is really 'i >= 0', but necessary for unsigned int wrapping */ \
-    for (i = L - 4; i != UINT_MAX; i--) { \
-      Y[i] = cf[0] * W[i] + cf[1] * Y[i + 1] + cf[2] * Y[i + 2] + cf[3] * Y[i + 3]; \
-    } \
-  } \
-  (void)0
-
-  // intermediate buffers
-  sz = max(src_width, src_height);
-  X = (double *)MEM_callocN(sz * sizeof(double), "IIR_gauss X buf");
-  Y = (double *)MEM_callocN(sz * sizeof(double), "IIR_gauss Y buf");
-  W = (double *)MEM_callocN(sz * sizeof(double), "IIR_gauss W buf");
+  // rows and columns are independent, filter them in parallel
+  IIRGaussData data;
+  data.coefs = &coefs;
+  data.buffer = buffer + chan;
   if (xy & 1) {  // H
-    int offset;
-    for (y = 0; y < src_height; y++) {
-      const int yx = y * src_width;
-      offset = yx * num_channels + chan;
-      for (x = 0; x < src_width; x++) {
-        X[x] = buffer[offset];
-        offset += num_channels;
-      }
-      YVV(src_width);
-      offset = yx * num_channels + chan;
-      for (x = 0; x < src_width; x++) {
-        buffer[offset] = Y[x];
-        offset += num_channels;
-      }
-    }
+    data.length = src_width;
+    data.line_stride = src_width * num_channels;
+    data.sample_stride = num_channels;
+    IIR_gauss_lines(&data, src_height);
   }
   if (xy & 2) {  // V
-    int offset;
-    const int add = src_width * num_channels;
-
-    for (x = 0; x < src_width; x++) {
-      offset = x * num_channels + chan;
-      for (y = 0; y < src_height; y++) {
-        X[y] = buffer[offset];
-        offset += add;
-      }
-      YVV(src_height);
-      offset = x * num_channels + chan;
-      for (y = 0; y < src_height; y++) {
-        buffer[offset] = Y[y];
-        offset += add;
-      }
-    }
+    data.length = src_height;
+    data.line_stride = num_channels;
+    data.sample_stride = src_width * num_channels;
+    IIR_gauss_lines(&data, src_width);
   }
-
-  MEM_freeN(X);
-  MEM_freeN(W);
-  MEM_freeN(Y);
-#undef YVV
 }
 
 ///
@@ -25,6 +25,8 @@ class FastGaussianBlurOperation : public BlurBaseOperation {
  private:
   float m_sx;
   float m_sy;
+  /* Sigma of the recursive gaussian relative to the blur size. */
+  float m_sigmaScale;
   MemoryBuffer *m_iirgaus;
 
  public:
@@ -38,6 +40,15 @@ class FastGaussianBlurOperation : public BlurBaseOperation {
   void *initializeTileData(rcti *rect);
   void deinitExecution();
   void initExecution();
+
+  /**
+   * Use a sigma of \a scale times the blur size, the default of 0.5 is the look of the
+   * Fast Gaussian filter type, 1/3 matches the Gaussian filter type.
+   */
+  void setSigmaScale(float scale)
+  {
+    this->m_sigmaScale = scale;
+  }
 };
 
 enum {
@@ -253,11 +253,15 @@ static void fht_convolve(fREAL *d1, const fREAL *d2, unsigned int M, unsigned in
 }
 //------------------------------------------------------------------------------
 
-static void convolve(float *dst, MemoryBuffer *in1, MemoryBuffer *in2)
+void GlareFogGlowOperation::convolve(float *dst,
+                                     MemoryBuffer *in1,
+                                     MemoryBuffer *in2,
+                                     unsigned int num_channels)
 {
   fREAL *data1, *data2, *fp;
   unsigned int w2, h2, hw, hh, log2_w, log2_h;
-  fRGB wt, *colp;
+  float wt[4];
+  fRGB *colp;
   int x, y, ch;
   int xbl, ybl, nxb, nyb, xbsz, ybsz;
   bool in2done = false;
@@ -281,30 +285,31 @@ static void convolve(float *dst, MemoryBuffer *in1, MemoryBuffer *in2)
   h2 = nextPow2(h2, &log2_h);
 
   // alloc space
-  data1 = (fREAL *)MEM_callocN(3 * w2 * h2 * sizeof(fREAL), "convolve_fast FHT data1");
+  data1 = (fREAL *)MEM_callocN(
+      num_channels * w2 * h2 * sizeof(fREAL), "convolve_fast FHT data1");
   data2 = (fREAL *)MEM_callocN(w2 * h2 * sizeof(fREAL), "convolve_fast FHT data2");
 
   // normalize convolutor
-  wt[0] = wt[1] = wt[2] = 0.0f;
+  zero_v4(wt);
   for (y = 0; y < kernelHeight; y++) {
     colp = (fRGB *)&kernelBuffer[y * kernelWidth * COM_NUM_CHANNELS_COLOR];
     for (x = 0; x < kernelWidth; x++) {
-      add_v3_v3(wt, colp[x]);
+      for (ch = 0; ch < num_channels; ch++) {
+        wt[ch] += colp[x][ch];
+      }
     }
   }
-  if (wt[0] != 0.0f) {
-    wt[0] = 1.0f / wt[0];
-  }
-  if (wt[1] != 0.0f) {
-    wt[1] = 1.0f / wt[1];
-  }
-  if (wt[2] != 0.0f) {
-    wt[2] = 1.0f / wt[2];
+  for (ch = 0; ch < num_channels; ch++) {
+    if (wt[ch] != 0.0f) {
+      wt[ch] = 1.0f / wt[ch];
+    }
   }
   for (y = 0; y < kernelHeight; y++) {
     colp = (fRGB *)&kernelBuffer[y * kernelWidth * COM_NUM_CHANNELS_COLOR];
     for (x = 0; x < kernelWidth; x++) {
-      mul_v3_v3(colp[x], wt);
+      for (ch = 0; ch < num_channels; ch++) {
+        colp[x][ch] *= wt[ch];
+      }
     }
   }
 
@@ -328,7 +333,7 @@ static void convolve(float *dst, MemoryBuffer *in1, MemoryBuffer *in2)
     for (xbl = 0; xbl < nxb; xbl++) {
 
       // each channel one by one
-      for (ch = 0; ch < 3; ch++) {
+      for (ch = 0; ch < num_channels; ch++) {
         fREAL *data1ch = &data1[ch * w2 * h2];
 
         // only need to calc fht data from in2 once, can re-use for every block
@@ -439,6 +444,6 @@ void GlareFogGlowOperation::generateGlare(float *data,
     }
   }
 
-  convolve(data, inputTile, ckrn);
+  convolve(data, inputTile, ckrn, 3);
   delete ckrn;
 }
@@ -28,6 +28,17 @@ class GlareFogGlowOperation : public GlareBaseOperation {
   {
   }
 
+  /**
+   * Convolve the first \a num_channels channels of color buffer \a in1 with the kernel in
+   * color buffer \a in2 using the Fast Hartley Transform, the cost does not depend on the
+   * kernel size. The kernel is normalized per channel (in place), the result is written to
+   * \a dst with the size of \a in1, other channels are set to zero.
+   */
+  static void convolve(float *dst,
+                       MemoryBuffer *in1,
+                       MemoryBuffer *in2,
+                       unsigned int num_channels);
+
  protected:
   void generateGlare(float *data, MemoryBuffer *inputTile, NodeGlare *settings);
 };
@@ -95,6 +95,48 @@ void MixBaseOperation::deinitExecution()
   this->m_inputColor2Operation = NULL;
 }
 
+#ifdef __SSE2__
+template<typename MixFunc>
+void MixBaseOperation::mixAreaSSE(MemoryBuffer *output, const rcti *area, const MixFunc &mix)
+{
+  MemoryBuffer *valueBuffer = this->createInputAreaBuffer(0, area);
+  MemoryBuffer *color1Buffer = this->createInputAreaBuffer(1, area);
+  MemoryBuffer *color2Buffer = this->createInputAreaBuffer(2, area);
+
+  const __m128 alpha_mask = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 one = _mm_set1_ps(1.0f);
+
+  for (int y = area->ymin; y < area->ymax; y++) {
+    const float *value = valueBuffer->getElem(area->xmin, y);
+    const float *color1 = color1Buffer->getElem(area->xmin, y);
+    const float *color2 = color2Buffer->getElem(area->xmin, y);
+    float *out = output->getElem(area->xmin, y);
+    for (int x = area->xmin; x < area->xmax; x++) {
+      const __m128 c1 = _mm_loadu_ps(color1);
+      const __m128 c2 = _mm_loadu_ps(color2);
+      const float fac = this->m_valueAlphaMultiply ? value[0] * color2[3] : value[0];
+
+      __m128 result = mix(_mm_set1_ps(fac), c1, c2);
+      result = _mm_or_ps(_mm_andnot_ps(alpha_mask, result), _mm_and_ps(alpha_mask, c1));
+      if (this->m_useClamp) {
+        result = _mm_min_ps(_mm_max_ps(result, zero), one);
+      }
+      _mm_storeu_ps(out, result);
+
+      value += 1;
+      color1 += 4;
+      color2 += 4;
+      out += 4;
+    }
+  }
+
+  delete valueBuffer;
+  delete color1Buffer;
+  delete color2Buffer;
+}
+#endif
+
 /* ******** Mix Add Operation ******** */
 
 MixAddOperation::MixAddOperation() : MixBaseOperation()
@@ -124,6 +166,15 @@ void MixAddOperation::executePixelSampled(float output[4], float x, float y, Pix
   clampIfNeeded(output);
 }
 
+#ifdef __SSE2__
+void MixAddOperation::executeArea(MemoryBuffer *output, const rcti *area)
+{
+  mixAreaSSE(output, area, [](__m128 value, __m128 c1, __m128 c2) {
+    return _mm_add_ps(c1, _mm_mul_ps(value, c2));
+  });
+}
+#endif
+
 /* ******** Mix Blend Operation ******** */
 
 MixBlendOperation::MixBlendOperation() : MixBaseOperation()
@@ -158,6 +209,16 @@ void MixBlendOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+#ifdef __SSE2__
+void MixBlendOperation::executeArea(MemoryBuffer *output, const rcti *area)
+{
+  mixAreaSSE(output, area, [](__m128 value, __m128 c1, __m128 c2) {
+    const __m128 valuem = _mm_sub_ps(_mm_set1_ps(1.0f), value);
+    return _mm_add_ps(_mm_mul_ps(valuem, c1), _mm_mul_ps(value, c2));
+  });
+}
+#endif
+
 /* ******** Mix Burn Operation ******** */
 
 MixColorBurnOperation::MixColorBurnOperation() : MixBaseOperation()
@@ -319,6 +380,16 @@ void MixDarkenOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+#ifdef __SSE2__
+void MixDarkenOperation::executeArea(MemoryBuffer *output, const rcti *area)
+{
+  mixAreaSSE(output, area, [](__m128 value, __m128 c1, __m128 c2) {
+    const __m128 valuem = _mm_sub_ps(_mm_set1_ps(1.0f), value);
+    return _mm_add_ps(_mm_mul_ps(_mm_min_ps(c1, c2), value), _mm_mul_ps(c1, valuem));
+  });
+}
+#endif
+
 /* ******** Mix Difference Operation ******** */
 
 MixDifferenceOperation::MixDifferenceOperation() : MixBaseOperation()
@@ -352,6 +423,17 @@ void MixDifferenceOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+#ifdef __SSE2__
+void MixDifferenceOperation::executeArea(MemoryBuffer *output, const rcti *area)
+{
+  mixAreaSSE(output, area, [](__m128 value, __m128 c1, __m128 c2) {
+    const __m128 valuem = _mm_sub_ps(_mm_set1_ps(1.0f), value);
+    const __m128 difference = _mm_andnot_ps(_mm_set1_ps(-0.0f), _mm_sub_ps(c1, c2));
+    return _mm_add_ps(_mm_mul_ps(valuem, c1), _mm_mul_ps(value, difference));
+  });
+}
+#endif
+
 /* ******** Mix Difference Operation ******** */
 
 MixDivideOperation::MixDivideOperation() : MixBaseOperation()
@@ -624,6 +706,15 @@ void MixLightenOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+#ifdef __SSE2__
+void MixLightenOperation::executeArea(MemoryBuffer *output, const rcti *area)
+{
+  mixAreaSSE(output, area, [](__m128 value, __m128 c1, __m128 c2) {
+    return _mm_max_ps(_mm_mul_ps(value, c2), c1);
+  });
+}
+#endif
+
 /* ******** Mix Linear Light Operation ******** */
 
 MixLinearLightOperation::MixLinearLightOperation() : MixBaseOperation()
@@ -705,6 +796,16 @@ void MixMultiplyOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+#ifdef __SSE2__
+void MixMultiplyOperation::executeArea(MemoryBuffer *output, const rcti *area)
+{
+  mixAreaSSE(output, area, [](__m128 value, __m128 c1, __m128 c2) {
+    const __m128 valuem = _mm_sub_ps(_mm_set1_ps(1.0f), value);
+    return _mm_mul_ps(c1, _mm_add_ps(valuem, _mm_mul_ps(value, c2)));
+  });
+}
+#endif
+
 /* ******** Mix Ovelray Operation ******** */
 
 MixOverlayOperation::MixOverlayOperation() : MixBaseOperation()
@@ -831,6 +932,18 @@ void MixScreenOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+#ifdef __SSE2__
+void MixScreenOperation::executeArea(MemoryBuffer *output, const rcti *area)
+{
+  mixAreaSSE(output, area, [](__m128 value, __m128 c1, __m128 c2) {
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 valuem = _mm_sub_ps(one, value);
+    const __m128 factor = _mm_add_ps(valuem, _mm_mul_ps(value, _mm_sub_ps(one, c2)));
+    return _mm_sub_ps(one, _mm_mul_ps(factor, _mm_sub_ps(one, c1)));
+  });
+}
+#endif
+
 /* ******** Mix Soft Light Operation ******** */
 
 MixSoftLightOperation::MixSoftLightOperation() : MixBaseOperation()
@@ -909,6 +1022,15 @@ void MixSubtractOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+#ifdef __SSE2__
+void MixSubtractOperation::executeArea(MemoryBuffer *output, const rcti *area)
+{
+  mixAreaSSE(output, area, [](__m128 value, __m128 c1, __m128 c2) {
+    return _mm_sub_ps(c1, _mm_mul_ps(value, c2));
+  });
+}
+#endif
+
 /* ******** Mix Value Operation ******** */
 
 MixValueOperation::MixValueOperation() : MixBaseOperation()
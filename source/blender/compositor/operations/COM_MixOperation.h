@@ -20,6 +20,10 @@
 
 #include "COM_NodeOperation.h"
 
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
 /**
  * All this programs converts an input color to an output value.
  * it assumes we are in sRGB color space.
@@ -43,6 +47,16 @@ class MixBaseOperation : public NodeOperation {
     }
   }
 
+#ifdef __SSE2__
+  /**
+   * Calculate \a area of the inputs into buffers and mix them one pixel per register.
+   * \a mix is called as `__m128 mix(__m128 value, __m128 color1, __m128 color2)` with the
+   * factor in all lanes, the alpha of the result is replaced by the alpha of color1.
+   */
+  template<typename MixFunc>
+  void mixAreaSSE(MemoryBuffer *output, const rcti *area, const MixFunc &mix);
+#endif
+
  public:
   /**
    * Default constructor
@@ -84,12 +98,18 @@ class MixAddOperation : public MixBaseOperation {
  public:
   MixAddOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+#ifdef __SSE2__
+  void executeArea(MemoryBuffer *output, const rcti *area);
+#endif
 };
 
 class MixBlendOperation : public MixBaseOperation {
  public:
   MixBlendOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+#ifdef __SSE2__
+  void executeArea(MemoryBuffer *output, const rcti *area);
+#endif
 };
 
 class MixColorBurnOperation : public MixBaseOperation {
@@ -108,12 +128,18 @@ class MixDarkenOperation : public MixBaseOperation {
  public:
   MixDarkenOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+#ifdef __SSE2__
+  void executeArea(MemoryBuffer *output, const rcti *area);
+#endif
 };
 
 class MixDifferenceOperation : public MixBaseOperation {
  public:
   MixDifferenceOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+#ifdef __SSE2__
+  void executeArea(MemoryBuffer *output, const rcti *area);
+#endif
 };
 
 class MixDivideOperation : public MixBaseOperation {
@@ -144,6 +170,9 @@ class MixLightenOperation : public MixBaseOperation {
  public:
   MixLightenOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+#ifdef __SSE2__
+  void executeArea(MemoryBuffer *output, const rcti *area);
+#endif
 };
 
 class MixLinearLightOperation : public MixBaseOperation {
@@ -156,6 +185,9 @@ class MixMultiplyOperation : public MixBaseOperation {
  public:
   MixMultiplyOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+#ifdef __SSE2__
+  void executeArea(MemoryBuffer *output, const rcti *area);
+#endif
 };
 
 class MixOverlayOperation : public MixBaseOperation {
@@ -174,6 +206,9 @@ class MixScreenOperation : public MixBaseOperation {
  public:
   MixScreenOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+#ifdef __SSE2__
+  void executeArea(MemoryBuffer *output, const rcti *area);
+#endif
 };
 
 class MixSoftLightOperation : public MixBaseOperation {
@@ -186,6 +221,9 @@ class MixSubtractOperation : public MixBaseOperation {
  public:
   MixSubtractOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+#ifdef __SSE2__
+  void executeArea(MemoryBuffer *output, const rcti *area);
+#endif
 };
 
 class MixValueOperation : public MixBaseOperation {
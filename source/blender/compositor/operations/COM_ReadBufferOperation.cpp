@@ -107,6 +107,26 @@ void ReadBufferOperation::executePixelFiltered(
   }
 }
 
+void ReadBufferOperation::executeArea(MemoryBuffer *output, const rcti *area)
+{
+  if (m_single_value) {
+    /* write buffer has a single value stored at (0,0) */
+    float value[4];
+    m_buffer->read(value, 0, 0);
+    output->fill(area, value);
+    return;
+  }
+
+  const int num_channels = output->get_num_channels();
+  for (int y = area->ymin; y < area->ymax; y++) {
+    float *out = output->getElem(area->xmin, y);
+    for (int x = area->xmin; x < area->xmax; x++) {
+      m_buffer->read(out, x, y);
+      out += num_channels;
+    }
+  }
+}
+
 bool ReadBufferOperation::determineDependingAreaOfInterest(rcti *input,
                                                            ReadBufferOperation *readOperation,
                                                            rcti *output)
@@ -31,6 +31,11 @@ void SetColorOperation::executePixelSampled(float output[4],
   copy_v4_v4(output, this->m_color);
 }
 
+void SetColorOperation::executeArea(MemoryBuffer *output, const rcti *area)
+{
+  output->fill(area, this->m_color);
+}
+
 void SetColorOperation::determineResolution(unsigned int resolution[2],
                                             unsigned int preferredResolution[2])
 {
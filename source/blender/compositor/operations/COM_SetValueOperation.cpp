@@ -31,6 +31,11 @@ void SetValueOperation::executePixelSampled(float output[4],
   output[0] = this->m_value;
 }
 
+void SetValueOperation::executeArea(MemoryBuffer *output, const rcti *area)
+{
+  output->fill(area, &this->m_value);
+}
+
 void SetValueOperation::determineResolution(unsigned int resolution[2],
                                             unsigned int preferredResolution[2])
 {
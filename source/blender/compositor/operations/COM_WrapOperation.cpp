@@ -77,6 +77,13 @@ void WrapOperation::executePixelSampled(float output[4], float x, float y, Pixel
   executePixelExtend(output, nx, ny, sampler, extend_x, extend_y);
 }
 
+void WrapOperation::executeArea(MemoryBuffer *output, const rcti *area)
+{
+  /* The row copy of #ReadBufferOperation::executeArea doesn't wrap, read pixel by pixel through
+   * #executePixelSampled instead. */
+  NodeOperation::executeArea(output, area);
+}
+
 bool WrapOperation::determineDependingAreaOfInterest(rcti *input,
                                                      ReadBufferOperation *readOperation,
                                                      rcti *output)
@@ -30,6 +30,7 @@ class WrapOperation : public ReadBufferOperation {
                                         ReadBufferOperation *readOperation,
                                         rcti *output);
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeArea(MemoryBuffer *output, const rcti *area);
 
   void setWrapping(int wrapping_type);
   float getWrappedOriginalXPos(float x);
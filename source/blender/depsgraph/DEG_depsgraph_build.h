@@ -93,6 +93,11 @@ void DEG_graph_relations_update(struct Depsgraph *graph,
 /* Tag all relations in the database for update.*/
 void DEG_relations_tag_update(struct Main *bmain);
 
+/* Tag relations of the given ID for update, for example after a modifier or constraint was added
+ * to an object. When possible only the nodes and relations of this ID are rebuilt, otherwise
+ * this is the same as DEG_relations_tag_update(). */
+void DEG_id_tag_relations_update(struct Main *bmain, struct ID *id);
+
 /* Add Dependencies  ----------------------------- */
 
 /* Handle for components to define their dependencies from callbacks.
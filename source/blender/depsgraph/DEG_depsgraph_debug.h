@@ -62,6 +62,11 @@ void DEG_debug_stats_gnuplot(const struct Depsgraph *graph,
                              const char *label,
                              const char *output_filename);
 
+/* Evaluation trace of the most recently evaluated operations, which is recorded while
+ * G_DEBUG_DEPSGRAPH_TRACE is enabled. Written in the Chrome trace event JSON format. */
+void DEG_debug_trace_chrome_json(const struct Depsgraph *graph, FILE *stream);
+void DEG_debug_trace_clear(struct Depsgraph *graph);
+
 /* ************************************************ */
 
 /* Compare two dependency graphs. */
@@ -27,9 +27,13 @@
 #include <cstdio>
 #include <cstdlib>
 
+#include "BLI_array.hh"
 #include "BLI_stack.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
+#include "atomic_ops.h"
+
 #include "intern/node/deg_node.h"
 #include "intern/node/deg_node_component.h"
 #include "intern/node/deg_node_operation.h"
@@ -218,10 +222,91 @@ void solve_cycles(CyclesSolverState *state)
   }
 }
 
+/* Check for cycles by repeatedly removing nodes which have no remaining dependencies (Kahn's
+ * algorithm), one generation of nodes at a time in parallel. Only tells whether there are
+ * cycles, the solver above is needed to report and break them. */
+struct AcyclicCheckState {
+  Depsgraph *graph;
+  /* Nodes of the current generation, and those becoming ready for the next one. */
+  Array<OperationNode *> current;
+  int num_current;
+  Array<OperationNode *> next;
+  int num_next;
+
+  AcyclicCheckState(Depsgraph *graph)
+      : graph(graph),
+        current(graph->operations.size()),
+        num_current(0),
+        next(graph->operations.size()),
+        num_next(0)
+  {
+  }
+};
+
+/* Count dependencies in custom_flags, nodes without any are the first generation. */
+void acyclic_check_init_func(void *__restrict data_v,
+                             const int i,
+                             const TaskParallelTLS *__restrict /*tls*/)
+{
+  AcyclicCheckState *state = (AcyclicCheckState *)data_v;
+  OperationNode *node = state->graph->operations[i];
+  int num_inlinks = 0;
+  for (Relation *rel : node->inlinks) {
+    if (rel->from->type == NodeType::OPERATION) {
+      num_inlinks++;
+    }
+  }
+  node->custom_flags = num_inlinks;
+  if (num_inlinks == 0) {
+    state->current[atomic_fetch_and_add_int32(&state->num_current, 1)] = node;
+  }
+}
+
+void acyclic_check_remove_func(void *__restrict data_v,
+                               const int i,
+                               const TaskParallelTLS *__restrict /*tls*/)
+{
+  AcyclicCheckState *state = (AcyclicCheckState *)data_v;
+  OperationNode *node = state->current[i];
+  for (Relation *rel : node->outlinks) {
+    if (rel->to->type != NodeType::OPERATION) {
+      continue;
+    }
+    OperationNode *to = (OperationNode *)rel->to;
+    if (atomic_sub_and_fetch_int32(&to->custom_flags, 1) == 0) {
+      state->next[atomic_fetch_and_add_int32(&state->num_next, 1)] = to;
+    }
+  }
+}
+
+bool graph_is_acyclic(Depsgraph *graph)
+{
+  AcyclicCheckState state(graph);
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1024;
+  BLI_task_parallel_range(0, graph->operations.size(), &state, acyclic_check_init_func, &settings);
+
+  int num_removed = 0;
+  while (state.num_current != 0) {
+    num_removed += state.num_current;
+    BLI_task_parallel_range(0, state.num_current, &state, acyclic_check_remove_func, &settings);
+    std::swap(state.current, state.next);
+    state.num_current = state.num_next;
+    state.num_next = 0;
+  }
+  return num_removed == graph->operations.size();
+}
+
 }  // namespace
 
 void deg_graph_detect_cycles(Depsgraph *graph)
 {
+  /* Most graphs don't have cycles, which is much cheaper to check in parallel. */
+  if (graph_is_acyclic(graph)) {
+    return;
+  }
+
   CyclesSolverState state(graph);
   /* First we solve cycles which are reachable from leaf nodes. */
   schedule_leaf_nodes(&state);
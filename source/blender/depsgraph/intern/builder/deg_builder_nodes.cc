@@ -112,6 +112,7 @@
 
 #include "intern/builder/deg_builder.h"
 #include "intern/depsgraph.h"
+#include "intern/depsgraph_relation.h"
 #include "intern/depsgraph_type.h"
 #include "intern/eval/deg_eval_copy_on_write.h"
 #include "intern/node/deg_node.h"
@@ -167,9 +168,13 @@ IDNode *DepsgraphNodeBuilder::add_id_node(ID *id)
     id_info->id_cow = nullptr;
   }
   id_node = graph_->add_id_node(id, id_cow);
-  id_node->previously_visible_components_mask = previously_visible_components_mask;
-  id_node->previous_eval_flags = previous_eval_flags;
-  id_node->previous_customdata_masks = previous_customdata_masks;
+  /* NOTE: Nodes which are kept by an incremental build have no ID info, their previous state is
+   * set by begin_build_incremental(). */
+  if (id_info != nullptr) {
+    id_node->previously_visible_components_mask = previously_visible_components_mask;
+    id_node->previous_eval_flags = previous_eval_flags;
+    id_node->previous_customdata_masks = previous_customdata_masks;
+  }
   /* Currently all ID nodes are supposed to have copy-on-write logic.
    *
    * NOTE: Zero number of components indicates that ID node was just created. */
@@ -339,16 +344,7 @@ void DepsgraphNodeBuilder::begin_build()
   }
 
   for (OperationNode *op_node : graph_->entry_tags) {
-    ComponentNode *comp_node = op_node->owner;
-    IDNode *id_node = comp_node->owner;
-
-    SavedEntryTag entry_tag;
-    entry_tag.id_orig = id_node->id_orig;
-    entry_tag.component_type = comp_node->type;
-    entry_tag.opcode = op_node->opcode;
-    entry_tag.name = op_node->name;
-    entry_tag.name_tag = op_node->name_tag;
-    saved_entry_tags_.append(entry_tag);
+    save_entry_tag(op_node);
   }
 
   /* Make sure graph has no nodes left from previous state. */
@@ -357,6 +353,70 @@ void DepsgraphNodeBuilder::begin_build()
   graph_->entry_tags.clear();
 }
 
+void DepsgraphNodeBuilder::begin_build_incremental(Span<Object *> objects)
+{
+  /* Remove operations of the objects together with all their relations. The ID nodes are kept,
+   * so are their copy-on-write datablocks. */
+  Set<OperationNode *> removed_operations;
+  for (Object *object : objects) {
+    IDNode *id_node = find_id_node(&object->id);
+    for (ComponentNode *comp_node : id_node->components.values()) {
+      for (OperationNode *op_node : comp_node->operations) {
+        if (graph_->entry_tags.remove(op_node)) {
+          save_entry_tag(op_node);
+        }
+        while (!op_node->inlinks.is_empty()) {
+          Relation *rel = op_node->inlinks.last();
+          rel->unlink();
+          delete rel;
+        }
+        while (!op_node->outlinks.is_empty()) {
+          Relation *rel = op_node->outlinks.last();
+          rel->unlink();
+          delete rel;
+        }
+        removed_operations.add_new(op_node);
+      }
+      delete comp_node;
+    }
+    id_node->components.clear();
+  }
+  Vector<OperationNode *> operations;
+  operations.reserve(graph_->operations.size() - removed_operations.size());
+  for (OperationNode *op_node : graph_->operations) {
+    if (!removed_operations.contains(op_node)) {
+      operations.append(op_node);
+    }
+  }
+  graph_->operations = std::move(operations);
+
+  for (IDNode *id_node : graph_->id_nodes) {
+    /* Current state is what the finalization compares against, same as the ID info does for
+     * full builds. */
+    id_node->previously_visible_components_mask = id_node->visible_components_mask;
+    id_node->previous_eval_flags = id_node->eval_flags;
+    id_node->previous_customdata_masks = id_node->customdata_masks;
+    /* Only the removed objects have no components left. */
+    if (!id_node->components.is_empty()) {
+      built_map_.tagBuild(id_node->id_orig);
+    }
+  }
+}
+
+void DepsgraphNodeBuilder::save_entry_tag(OperationNode *op_node)
+{
+  ComponentNode *comp_node = op_node->owner;
+  IDNode *id_node = comp_node->owner;
+
+  SavedEntryTag entry_tag;
+  entry_tag.id_orig = id_node->id_orig;
+  entry_tag.component_type = comp_node->type;
+  entry_tag.opcode = op_node->opcode;
+  entry_tag.name = op_node->name;
+  entry_tag.name_tag = op_node->name_tag;
+  saved_entry_tags_.append(entry_tag);
+}
+
 void DepsgraphNodeBuilder::end_build()
 {
   for (const SavedEntryTag &entry_tag : saved_entry_tags_) {
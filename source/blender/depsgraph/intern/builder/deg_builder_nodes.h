@@ -101,6 +101,10 @@ class DepsgraphNodeBuilder : public DepsgraphBuilder {
   virtual void begin_build();
   virtual void end_build();
 
+  /* Prepare to build nodes of the given objects into an already built graph: current nodes of
+   * the objects are removed, nodes of all other IDs are kept and are not built again. */
+  virtual void begin_build_incremental(Span<Object *> objects);
+
   IDNode *add_id_node(ID *id);
   IDNode *find_id_node(ID *id);
   TimeSourceNode *add_time_source();
@@ -162,6 +166,9 @@ class DepsgraphNodeBuilder : public DepsgraphBuilder {
   virtual void build_view_layer(Scene *scene,
                                 ViewLayer *view_layer,
                                 eDepsNode_LinkedState_Type linked_state);
+  virtual void build_view_layer_objects(Scene *scene,
+                                        ViewLayer *view_layer,
+                                        Span<Object *> objects);
   virtual void build_collection(LayerCollection *from_layer_collection, Collection *collection);
   virtual void build_object(int base_index,
                             Object *object,
@@ -259,6 +266,8 @@ class DepsgraphNodeBuilder : public DepsgraphBuilder {
   };
   Vector<SavedEntryTag> saved_entry_tags_;
 
+  void save_entry_tag(OperationNode *op_node);
+
   struct BuilderWalkUserData {
     DepsgraphNodeBuilder *builder;
     /* Denotes whether object the walk is invoked from is visible. */
@@ -53,6 +53,7 @@
 #include "intern/depsgraph_type.h"
 #include "intern/node/deg_node.h"
 #include "intern/node/deg_node_component.h"
+#include "intern/node/deg_node_id.h"
 #include "intern/node/deg_node_operation.h"
 
 namespace blender {
@@ -175,5 +176,35 @@ void DepsgraphNodeBuilder::build_view_layer(Scene *scene,
   }
 }
 
+void DepsgraphNodeBuilder::build_view_layer_objects(Scene *scene,
+                                                    ViewLayer *view_layer,
+                                                    Span<Object *> objects)
+{
+  /* Same context as build_view_layer(). */
+  view_layer_index_ = 0;
+  scene_ = scene;
+  view_layer_ = view_layer;
+  /* Base indices are counted the same way as when building the whole view layer. */
+  Map<const Object *, int> base_index_map;
+  int base_index = 0;
+  LISTBASE_FOREACH (Base *, base, &view_layer->object_bases) {
+    if (need_pull_base_into_graph(base)) {
+      base_index_map.add(base->object, base_index);
+      base_index++;
+    }
+  }
+  for (Object *object : objects) {
+    const int object_base_index = base_index_map.lookup_default(object, -1);
+    if (object_base_index != -1) {
+      build_object(object_base_index, object, DEG_ID_LINKED_DIRECTLY, true);
+    }
+    else {
+      /* Object is only pulled in by other IDs, keep the state they have given it. */
+      const IDNode *id_node = find_id_node(&object->id);
+      build_object(-1, object, id_node->linked_state, id_node->is_directly_visible);
+    }
+  }
+}
+
 }  // namespace deg
 }  // namespace blender
@@ -31,7 +31,9 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_array.hh"
 #include "BLI_blenlib.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "DNA_action_types.h"
@@ -478,6 +480,13 @@ void DepsgraphRelationBuilder::begin_build()
 {
 }
 
+void DepsgraphRelationBuilder::begin_build_incremental(Span<ID *> built_ids)
+{
+  for (ID *id : built_ids) {
+    built_map_.tagBuild(id);
+  }
+}
+
 void DepsgraphRelationBuilder::build_id(ID *id)
 {
   if (id == nullptr) {
@@ -2745,10 +2754,49 @@ void DepsgraphRelationBuilder::build_scene_speakers(Scene * /*scene*/, ViewLayer
   }
 }
 
+namespace {
+
+struct CopyOnWriteRelationsData {
+  DepsgraphRelationBuilder *builder;
+  Span<IDNode *> id_nodes;
+  Array<Vector<DepsgraphRelationBuilder::PendingRelation>> *relations;
+};
+
+void build_copy_on_write_relations_func(void *__restrict data_v,
+                                        const int i,
+                                        const TaskParallelTLS *__restrict /*tls*/)
+{
+  CopyOnWriteRelationsData *data = (CopyOnWriteRelationsData *)data_v;
+  data->builder->build_copy_on_write_relations(data->id_nodes[i], (*data->relations)[i]);
+}
+
+}  // namespace
+
 void DepsgraphRelationBuilder::build_copy_on_write_relations()
 {
-  for (IDNode *id_node : graph_->id_nodes) {
-    build_copy_on_write_relations(id_node);
+  build_copy_on_write_relations(graph_->id_nodes);
+}
+
+void DepsgraphRelationBuilder::build_copy_on_write_relations(Span<IDNode *> id_nodes)
+{
+  /* Relations of every ID only depend on the nodes of the ID itself, so they are gathered in
+   * parallel. They are added afterwards in the order of IDs, so the graph does not depend on
+   * the threads scheduling. */
+  const int num_id_nodes = id_nodes.size();
+  Array<Vector<PendingRelation>> relations(num_id_nodes);
+  CopyOnWriteRelationsData data;
+  data.builder = this;
+  data.id_nodes = id_nodes;
+  data.relations = &relations;
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 64;
+  BLI_task_parallel_range(0, num_id_nodes, &data, build_copy_on_write_relations_func, &settings);
+
+  for (const Vector<PendingRelation> &id_relations : relations) {
+    for (const PendingRelation &relation : id_relations) {
+      add_operation_relation(relation.from, relation.to, relation.description, relation.flags);
+    }
   }
 }
 
@@ -2781,7 +2829,20 @@ void DepsgraphRelationBuilder::build_nested_shapekey(ID *owner, Key *key)
   build_nested_datablock(owner, &key->id);
 }
 
-void DepsgraphRelationBuilder::build_copy_on_write_relations(IDNode *id_node)
+/* Check for a relation which was added by a previous build, used when building incrementally. */
+static bool has_copy_on_write_relation(const OperationNode *op_from, const OperationNode *op_to)
+{
+  for (const Relation *rel : op_to->inlinks) {
+    if (rel->from == op_from) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/* NOTE: Called from multiple threads, must not modify the graph. */
+void DepsgraphRelationBuilder::build_copy_on_write_relations(IDNode *id_node,
+                                                             Vector<PendingRelation> &r_relations)
 {
   ID *id_orig = id_node->id_orig;
   const ID_Type id_type = GS(id_orig->name);
@@ -2791,8 +2852,7 @@ void DepsgraphRelationBuilder::build_copy_on_write_relations(IDNode *id_node)
   // add_relation(time_source_key, copy_on_write_key, "Fluxgate capacitor hack");
   /* Resat of code is using rather low level trickery, so need to get some
    * explicit pointers. */
-  Node *node_cow = find_node(copy_on_write_key);
-  OperationNode *op_cow = node_cow->get_exit_operation();
+  OperationNode *op_cow = find_node(copy_on_write_key);
   /* Plug any other components to this one. */
   for (ComponentNode *comp_node : id_node->components.values()) {
     if (comp_node->type == NodeType::COPY_ON_WRITE) {
@@ -2832,36 +2892,39 @@ void DepsgraphRelationBuilder::build_copy_on_write_relations(IDNode *id_node)
     /* All entry operations of each component should wait for a proper
      * copy of ID. */
     OperationNode *op_entry = comp_node->get_entry_operation();
-    if (op_entry != nullptr) {
-      Relation *rel = graph_->add_new_relation(op_cow, op_entry, "CoW Dependency");
-      rel->flag |= rel_flag;
+    if (op_entry != nullptr && !has_copy_on_write_relation(op_cow, op_entry)) {
+      r_relations.append({op_cow, op_entry, "CoW Dependency", rel_flag});
     }
-    /* All dangling operations should also be executed after copy-on-write. */
-    for (OperationNode *op_node : comp_node->operations_map->values()) {
+    /* All dangling operations should also be executed after copy-on-write.
+     *
+     * NOTE: Components which were finalized by a previous build only have operations in the
+     * vector, their new operations are added there by incremental builds. */
+    auto add_dangling_operation_relation = [&](OperationNode *op_node) {
       if (op_node == op_entry) {
-        continue;
+        return;
       }
       if (op_node->inlinks.is_empty()) {
-        Relation *rel = graph_->add_new_relation(op_cow, op_node, "CoW Dependency");
-        rel->flag |= rel_flag;
+        r_relations.append({op_cow, op_node, "CoW Dependency", rel_flag});
+        return;
       }
-      else {
-        bool has_same_comp_dependency = false;
-        for (Relation *rel_current : op_node->inlinks) {
-          if (rel_current->from->type != NodeType::OPERATION) {
-            continue;
-          }
-          OperationNode *op_node_from = (OperationNode *)rel_current->from;
-          if (op_node_from->owner == op_node->owner) {
-            has_same_comp_dependency = true;
-            break;
-          }
+      for (Relation *rel_current : op_node->inlinks) {
+        if (rel_current->from->type != NodeType::OPERATION) {
+          continue;
         }
-        if (!has_same_comp_dependency) {
-          Relation *rel = graph_->add_new_relation(op_cow, op_node, "CoW Dependency");
-          rel->flag |= rel_flag;
+        OperationNode *op_node_from = (OperationNode *)rel_current->from;
+        if (op_node_from->owner == op_node->owner || op_node_from == op_cow) {
+          return;
         }
       }
+      r_relations.append({op_cow, op_node, "CoW Dependency", rel_flag});
+    };
+    if (comp_node->operations_map != nullptr) {
+      for (OperationNode *op_node : comp_node->operations_map->values()) {
+        add_dangling_operation_relation(op_node);
+      }
+    }
+    for (OperationNode *op_node : comp_node->operations) {
+      add_dangling_operation_relation(op_node);
     }
     /* NOTE: We currently ignore implicit relations to an external
      * data-blocks for copy-on-write operations. This means, for example,
@@ -2880,8 +2943,10 @@ void DepsgraphRelationBuilder::build_copy_on_write_relations(IDNode *id_node)
       if (deg_copy_on_write_is_needed(object_data_id)) {
         OperationKey data_copy_on_write_key(
             object_data_id, NodeType::COPY_ON_WRITE, OperationCode::COPY_ON_WRITE);
-        add_relation(
-            data_copy_on_write_key, copy_on_write_key, "Eval Order", RELATION_FLAG_GODMODE);
+        OperationNode *op_data_cow = find_node(data_copy_on_write_key);
+        if (!has_copy_on_write_relation(op_data_cow, op_cow)) {
+          r_relations.append({op_data_cow, op_cow, "Eval Order", RELATION_FLAG_GODMODE});
+        }
       }
     }
     else {
@@ -165,6 +165,10 @@ class DepsgraphRelationBuilder : public DepsgraphBuilder {
 
   void begin_build();
 
+  /* Prepare to build relations into an already built graph, relations of the \a built_ids are
+   * kept and are not built again. */
+  void begin_build_incremental(Span<ID *> built_ids);
+
   template<typename KeyFrom, typename KeyTo>
   Relation *add_relation(const KeyFrom &key_from,
                          const KeyTo &key_to,
@@ -209,6 +213,7 @@ class DepsgraphRelationBuilder : public DepsgraphBuilder {
   virtual void build_view_layer(Scene *scene,
                                 ViewLayer *view_layer,
                                 eDepsNode_LinkedState_Type linked_state);
+  virtual void build_view_layer_objects(Scene *scene, Span<Object *> objects);
   virtual void build_collection(LayerCollection *from_layer_collection,
                                 Object *object,
                                 Collection *collection);
@@ -310,8 +315,19 @@ class DepsgraphRelationBuilder : public DepsgraphBuilder {
                                          bool add_absorption,
                                          const char *name);
 
+  /* Relation which is added to the graph once all of them are known, this allows to gather
+   * relations from multiple threads. */
+  struct PendingRelation {
+    OperationNode *from;
+    OperationNode *to;
+    const char *description;
+    int flags;
+  };
+
   virtual void build_copy_on_write_relations();
-  virtual void build_copy_on_write_relations(IDNode *id_node);
+  virtual void build_copy_on_write_relations(Span<IDNode *> id_nodes);
+  virtual void build_copy_on_write_relations(IDNode *id_node,
+                                             Vector<PendingRelation> &r_relations);
   virtual void build_driver_relations();
   virtual void build_driver_relations(IDNode *id_node);
 
@@ -154,5 +154,14 @@ void DepsgraphRelationBuilder::build_view_layer(Scene *scene,
   }
 }
 
+void DepsgraphRelationBuilder::build_view_layer_objects(Scene *scene, Span<Object *> objects)
+{
+  /* Same context as build_view_layer(). */
+  scene_ = scene;
+  for (Object *object : objects) {
+    build_object(object);
+  }
+}
+
 }  // namespace deg
 }  // namespace blender
@@ -25,6 +25,10 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_array.hh"
+#include "BLI_set.hh"
+#include "BLI_task.h"
+
 #include "intern/node/deg_node.h"
 #include "intern/node/deg_node_component.h"
 #include "intern/node/deg_node_operation.h"
@@ -70,8 +74,93 @@ static void deg_graph_tag_paths_recursive(Node *node)
   }
 }
 
+/* Same as above, tags are stored in sets so multiple targets can be handled at once. */
+static void deg_graph_find_paths_recursive(Node *node,
+                                           Set<Node *> &visited,
+                                           Set<Node *> &reachable)
+{
+  if (!visited.add(node)) {
+    return;
+  }
+  for (Relation *rel : node->inlinks) {
+    deg_graph_find_paths_recursive(rel->from, visited, reachable);
+    reachable.add(rel->from);
+  }
+}
+
+struct TransitiveReductionData {
+  Depsgraph *graph;
+  /* Redundant relations, per target operation. */
+  Array<Vector<Relation *>> *relations_to_remove;
+};
+
+static void deg_graph_find_redundant_relations_func(void *__restrict data_v,
+                                                    const int i,
+                                                    const TaskParallelTLS *__restrict /*tls*/)
+{
+  TransitiveReductionData *data = (TransitiveReductionData *)data_v;
+  OperationNode *target = data->graph->operations[i];
+  Set<Node *> visited;
+  Set<Node *> reachable;
+  visited.add(target);
+  for (Relation *rel : target->inlinks) {
+    deg_graph_find_paths_recursive(rel->from, visited, reachable);
+  }
+  for (Relation *rel : target->inlinks) {
+    if (rel->from->type == NodeType::TIMESOURCE) {
+      continue;
+    }
+    if (reachable.contains(rel->from)) {
+      (*data->relations_to_remove)[i].append(rel);
+    }
+  }
+}
+
+static bool deg_graph_has_cyclic_relations(Depsgraph *graph)
+{
+  for (OperationNode *node : graph->operations) {
+    for (Relation *rel : node->inlinks) {
+      if (rel->flag & RELATION_FLAG_CYCLIC) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/* Without cycles removing redundant relations keeps all paths, so all of them can be found
+ * on the unmodified graph and removed afterwards. */
+static int deg_graph_transitive_reduction_parallel(Depsgraph *graph)
+{
+  const int num_operations = graph->operations.size();
+  Array<Vector<Relation *>> relations_to_remove(num_operations);
+  TransitiveReductionData data;
+  data.graph = graph;
+  data.relations_to_remove = &relations_to_remove;
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  BLI_task_parallel_range(
+      0, num_operations, &data, deg_graph_find_redundant_relations_func, &settings);
+
+  int num_removed_relations = 0;
+  for (const Vector<Relation *> &relations : relations_to_remove) {
+    for (Relation *rel : relations) {
+      rel->unlink();
+      delete rel;
+    }
+    num_removed_relations += relations.size();
+  }
+  return num_removed_relations;
+}
+
 void deg_graph_transitive_reduction(Depsgraph *graph)
 {
+  if (!deg_graph_has_cyclic_relations(graph)) {
+    const int num_removed_relations = deg_graph_transitive_reduction_parallel(graph);
+    DEG_DEBUG_PRINTF((::Depsgraph *)graph, BUILD, "Removed %d relations\n", num_removed_relations);
+    return;
+  }
+
   int num_removed_relations = 0;
   Vector<Relation *> relations_to_remove;
 
@@ -30,6 +30,8 @@
 #include "deg_builder_relations.h"
 #include "deg_builder_transitive.h"
 
+#include "intern/eval/deg_eval_stats.h"
+
 namespace blender {
 namespace deg {
 
@@ -103,6 +105,8 @@ void AbstractBuilderPipeline::build_step_finalize()
   if (G.debug_value == 799) {
     deg_graph_transitive_reduction(deg_graph_);
   }
+  /* Initial estimate of critical paths, refined by measured costs during evaluation. */
+  deg_eval_critical_paths_update(deg_graph_);
   /* Store pointers to commonly used valuated datablocks. */
   deg_graph_->scene_cow = (Scene *)deg_graph_->get_cow_id(&deg_graph_->scene->id);
   /* Flush visibility layer and re-schedule nodes for update. */
@@ -116,6 +120,7 @@ void AbstractBuilderPipeline::build_step_finalize()
 #endif
   /* Relations are up to date. */
   deg_graph_->need_update = false;
+  deg_graph_->need_update_relations_ids.clear();
 }
 
 unique_ptr<DepsgraphNodeBuilder> AbstractBuilderPipeline::construct_node_builder()
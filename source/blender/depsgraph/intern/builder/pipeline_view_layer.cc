@@ -19,9 +19,22 @@
 
 #include "pipeline_view_layer.h"
 
+#include "PIL_time.h"
+
+#include "BLI_utildefines.h"
+
+#include "BKE_global.h"
+
+#include "DNA_modifier_types.h"
+#include "DNA_object_force_types.h"
+#include "DNA_object_types.h"
+
 #include "intern/builder/deg_builder_nodes.h"
 #include "intern/builder/deg_builder_relations.h"
 #include "intern/depsgraph.h"
+#include "intern/depsgraph_relation.h"
+#include "intern/node/deg_node_component.h"
+#include "intern/node/deg_node_id.h"
 
 namespace blender {
 namespace deg {
@@ -44,5 +57,277 @@ void ViewLayerBuilderPipeline::build_relations(DepsgraphRelationBuilder &relatio
   relation_builder.build_view_layer(scene_, view_layer_, DEG_ID_LINKED_DIRECTLY);
 }
 
+ViewLayerIncrementalBuilderPipeline::ViewLayerIncrementalBuilderPipeline(::Depsgraph *graph,
+                                                                         Main *bmain,
+                                                                         Scene *scene,
+                                                                         ViewLayer *view_layer)
+    : ViewLayerBuilderPipeline(graph, bmain, scene, view_layer)
+{
+}
+
+namespace {
+
+/* Objects which are not only built by their own builders, or which other objects depend on
+ * through the physics relations which are cached in the graph, need the whole graph rebuilt. */
+bool object_can_be_rebuilt_incrementally(const Object *object, const IDNode *id_node)
+{
+  if (id_node->linked_state == DEG_ID_LINKED_VIA_SET) {
+    return false;
+  }
+  if (object->proxy != nullptr || object->proxy_from != nullptr) {
+    return false;
+  }
+  if (object->rigidbody_object != nullptr || object->rigidbody_constraint != nullptr) {
+    return false;
+  }
+  if (object->pd != nullptr && object->pd->forcefield != PFIELD_NULL) {
+    return false;
+  }
+  LISTBASE_FOREACH (const ModifierData *, md, &object->modifiers) {
+    if (ELEM(md->type, eModifierType_Collision, eModifierType_Fluid, eModifierType_DynamicPaint)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Drivers of other IDs add operations for the ID properties they read to the object. Builders of
+ * the object do not build these operations again. */
+bool has_id_properties_read_by_other_ids(const IDNode *id_node)
+{
+  for (const ComponentNode *comp_node : id_node->components.values()) {
+    for (const OperationNode *op_node : comp_node->operations) {
+      if (op_node->opcode != OperationCode::ID_PROPERTY) {
+        continue;
+      }
+      for (const Relation *rel : op_node->outlinks) {
+        if (rel->to->type != NodeType::OPERATION) {
+          continue;
+        }
+        const OperationNode *op_to = (OperationNode *)rel->to;
+        if (op_to->owner->owner != id_node) {
+          return true;
+        }
+      }
+    }
+  }
+  return false;
+}
+
+bool has_relation(const Node *from, const Node *to, const char *description)
+{
+  for (const Relation *rel : to->inlinks) {
+    if (rel->from == from && STREQ(rel->name, description)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+bool ViewLayerIncrementalBuilderPipeline::collect_objects_to_rebuild(Vector<Object *> &r_objects)
+{
+  if (deg_graph_->scene != scene_ || deg_graph_->view_layer != view_layer_) {
+    return false;
+  }
+  /* Follow the order of ID nodes, so the result does not depend on the order of tagging. Tagged
+   * IDs which are not in the graph are ignored: nothing in the graph depends on them. */
+  for (IDNode *id_node : deg_graph_->id_nodes) {
+    if (!deg_graph_->need_update_relations_ids.contains(id_node->id_orig)) {
+      continue;
+    }
+    if (id_node->id_type != ID_OB) {
+      return false;
+    }
+    Object *object = (Object *)id_node->id_orig;
+    if (!object_can_be_rebuilt_incrementally(object, id_node) ||
+        has_id_properties_read_by_other_ids(id_node)) {
+      return false;
+    }
+    r_objects.append(object);
+  }
+  return true;
+}
+
+Vector<ViewLayerIncrementalBuilderPipeline::SavedRelation> ViewLayerIncrementalBuilderPipeline::
+    save_relations(Span<Object *> objects, const Set<ID *> &rebuild_ids)
+{
+  Vector<SavedRelation> relations;
+  for (Object *object : objects) {
+    IDNode *id_node = deg_graph_->find_id_node(&object->id);
+    for (ComponentNode *comp_node : id_node->components.values()) {
+      for (OperationNode *op_node : comp_node->operations) {
+        for (Relation *rel : op_node->outlinks) {
+          if (rel->to->type != NodeType::OPERATION) {
+            continue;
+          }
+          const OperationNode *op_to = (OperationNode *)rel->to;
+          if (rebuild_ids.contains(op_to->owner->owner->id_orig)) {
+            continue;
+          }
+          SavedRelation relation;
+          relation.id = id_node->id_orig;
+          relation.component_type = comp_node->type;
+          relation.component_name = comp_node->name;
+          relation.opcode = op_node->opcode;
+          relation.name = op_node->name;
+          relation.name_tag = op_node->name_tag;
+          relation.to = rel->to;
+          relation.description = rel->name;
+          relation.flag = rel->flag & ~(RELATION_FLAG_CYCLIC | RELATION_CHECK_BEFORE_ADD);
+          relations.append(relation);
+        }
+      }
+    }
+  }
+  return relations;
+}
+
+Vector<ViewLayerIncrementalBuilderPipeline::SavedInlink> ViewLayerIncrementalBuilderPipeline::
+    save_inlinks(Span<Object *> objects, const Set<ID *> &rebuild_ids)
+{
+  Vector<SavedInlink> inlinks;
+  for (Object *object : objects) {
+    IDNode *id_node = deg_graph_->find_id_node(&object->id);
+    for (ComponentNode *comp_node : id_node->components.values()) {
+      for (OperationNode *op_node : comp_node->operations) {
+        for (Relation *rel : op_node->inlinks) {
+          if (rel->from->type != NodeType::OPERATION) {
+            continue;
+          }
+          const OperationNode *op_from = (OperationNode *)rel->from;
+          if (rebuild_ids.contains(op_from->owner->owner->id_orig)) {
+            continue;
+          }
+          SavedInlink inlink;
+          inlink.from = rel->from;
+          inlink.id = id_node->id_orig;
+          inlink.component_type = comp_node->type;
+          inlink.component_name = comp_node->name;
+          inlink.opcode = op_node->opcode;
+          inlink.name = op_node->name;
+          inlink.name_tag = op_node->name_tag;
+          inlink.description = rel->name;
+          inlinks.append(inlink);
+        }
+      }
+    }
+  }
+  return inlinks;
+}
+
+void ViewLayerIncrementalBuilderPipeline::restore_relations(Span<SavedRelation> relations)
+{
+  for (const SavedRelation &relation : relations) {
+    IDNode *id_node = deg_graph_->find_id_node(relation.id);
+    ComponentNode *comp_node = id_node->find_component(relation.component_type,
+                                                       relation.component_name.c_str());
+    if (comp_node == nullptr) {
+      continue;
+    }
+    OperationNode *op_node = comp_node->find_operation(
+        relation.opcode, relation.name.c_str(), relation.name_tag);
+    if (op_node == nullptr) {
+      /* Operation is not needed by the object anymore. */
+      continue;
+    }
+    /* Builders of the objects might have added the same relation already. */
+    if (has_relation(op_node, relation.to, relation.description)) {
+      continue;
+    }
+    deg_graph_->add_new_relation(op_node, relation.to, relation.description, relation.flag);
+  }
+}
+
+/* Check that the builders of the objects added the relations from other IDs again. The check is
+ * conservative: relations which are not needed anymore after the change of the object also lead
+ * to building the graph from scratch. */
+bool ViewLayerIncrementalBuilderPipeline::inlinks_rebuilt(Span<SavedInlink> inlinks)
+{
+  for (const SavedInlink &inlink : inlinks) {
+    IDNode *id_node = deg_graph_->find_id_node(inlink.id);
+    ComponentNode *comp_node = id_node->find_component(inlink.component_type,
+                                                       inlink.component_name.c_str());
+    if (comp_node == nullptr) {
+      return false;
+    }
+    OperationNode *op_node = comp_node->find_operation(
+        inlink.opcode, inlink.name.c_str(), inlink.name_tag);
+    if (op_node == nullptr || !has_relation(inlink.from, op_node, inlink.description.c_str())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ViewLayerIncrementalBuilderPipeline::build_incremental()
+{
+  Vector<Object *> objects;
+  if (!collect_objects_to_rebuild(objects)) {
+    return false;
+  }
+  if (objects.is_empty()) {
+    deg_graph_->need_update_relations_ids.clear();
+    return true;
+  }
+
+  double start_time = 0.0;
+  if (G.debug & (G_DEBUG_DEPSGRAPH_BUILD | G_DEBUG_DEPSGRAPH_TIME)) {
+    start_time = PIL_check_seconds_timer();
+  }
+
+  Set<ID *> rebuild_ids;
+  for (Object *object : objects) {
+    rebuild_ids.add_new(&object->id);
+  }
+  /* IDs which keep their nodes and relations, this does not include IDs which are new to the
+   * graph, their relations are to be built as well. */
+  Vector<ID *> built_ids;
+  for (IDNode *id_node : deg_graph_->id_nodes) {
+    if (!rebuild_ids.contains(id_node->id_orig)) {
+      built_ids.append(id_node->id_orig);
+    }
+  }
+  Vector<SavedRelation> saved_relations = save_relations(objects, rebuild_ids);
+  Vector<SavedInlink> saved_inlinks = save_inlinks(objects, rebuild_ids);
+  const int num_id_nodes = deg_graph_->id_nodes.size();
+
+  unique_ptr<DepsgraphNodeBuilder> node_builder = construct_node_builder();
+  node_builder->begin_build_incremental(objects);
+  const int num_operations = deg_graph_->operations.size();
+  node_builder->build_view_layer_objects(scene_, view_layer_, objects);
+  node_builder->end_build();
+
+  unique_ptr<DepsgraphRelationBuilder> relation_builder = construct_relation_builder();
+  relation_builder->begin_build_incremental(built_ids);
+  relation_builder->build_view_layer_objects(scene_, objects);
+  /* New operations are not necessarily owned by the rebuilt objects or new IDs, for example
+   * drivers add ID property operations to the IDs they read from. */
+  VectorSet<IDNode *> id_nodes_with_new_operations;
+  for (int i = num_operations; i < deg_graph_->operations.size(); i++) {
+    id_nodes_with_new_operations.add(deg_graph_->operations[i]->owner->owner);
+  }
+  relation_builder->build_copy_on_write_relations(id_nodes_with_new_operations);
+  for (Object *object : objects) {
+    relation_builder->build_driver_relations(deg_graph_->find_id_node(&object->id));
+  }
+  for (int i = num_id_nodes; i < deg_graph_->id_nodes.size(); i++) {
+    relation_builder->build_driver_relations(deg_graph_->id_nodes[i]);
+  }
+  if (!inlinks_rebuilt(saved_inlinks)) {
+    return false;
+  }
+  restore_relations(saved_relations);
+
+  build_step_finalize();
+
+  if (G.debug & (G_DEBUG_DEPSGRAPH_BUILD | G_DEBUG_DEPSGRAPH_TIME)) {
+    printf("Depsgraph updated incrementally in %f seconds.\n",
+           PIL_check_seconds_timer() - start_time);
+  }
+  return true;
+}
+
 }  // namespace deg
 }  // namespace blender
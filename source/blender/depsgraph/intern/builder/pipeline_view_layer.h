@@ -25,6 +25,9 @@
 
 #include "pipeline.h"
 
+#include "intern/node/deg_node.h"
+#include "intern/node/deg_node_operation.h"
+
 namespace blender {
 namespace deg {
 
@@ -37,5 +40,56 @@ class ViewLayerBuilderPipeline : public AbstractBuilderPipeline {
   virtual void build_relations(DepsgraphRelationBuilder &relation_builder) override;
 };
 
+/* Updates an already built graph of the view layer after relations of some of its IDs were tagged
+ * for update, see DEG_id_tag_relations_update(). Only nodes and relations of these IDs are built
+ * again, everything else is kept as-is. */
+class ViewLayerIncrementalBuilderPipeline : public ViewLayerBuilderPipeline {
+ public:
+  ViewLayerIncrementalBuilderPipeline(::Depsgraph *graph,
+                                      Main *bmain,
+                                      Scene *scene,
+                                      ViewLayer *view_layer);
+
+  /* Returns false when the graph can not be updated incrementally and needs to be built from
+   * scratch instead. The graph might be partially updated in that case. */
+  bool build_incremental();
+
+ protected:
+  /* Relation from an operation of a rebuilt object to an operation of another ID. Such relations
+   * are added by the builders of the other IDs, so they are saved and restored. Relations into
+   * the rebuilt objects are added by their own builders. */
+  struct SavedRelation {
+    ID *id;
+    NodeType component_type;
+    string component_name;
+    OperationCode opcode;
+    string name;
+    int name_tag;
+    Node *to;
+    const char *description;
+    int flag;
+  };
+
+  /* Relation from an operation of another ID to an operation of a rebuilt object. Builders of the
+   * other IDs might have added it, in which case the builders of the objects do not add it again
+   * and the graph is built from scratch. */
+  struct SavedInlink {
+    Node *from;
+    ID *id;
+    NodeType component_type;
+    string component_name;
+    OperationCode opcode;
+    string name;
+    int name_tag;
+    string description;
+  };
+
+  bool collect_objects_to_rebuild(Vector<Object *> &r_objects);
+  Vector<SavedRelation> save_relations(Span<Object *> objects, const Set<ID *> &rebuild_ids);
+  Vector<SavedInlink> save_inlinks(Span<Object *> objects, const Set<ID *> &rebuild_ids);
+  void restore_relations(Span<SavedRelation> relations);
+  bool inlinks_rebuilt(Span<SavedInlink> inlinks);
+};
+
 }  // namespace deg
 }  // namespace blender
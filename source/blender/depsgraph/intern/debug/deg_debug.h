@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include "intern/debug/deg_debug_trace.h"
 #include "intern/debug/deg_time_average.h"
 #include "intern/depsgraph_type.h"
 
@@ -38,6 +39,7 @@ class DepsgraphDebug {
   DepsgraphDebug();
 
   bool do_time_debug() const;
+  bool do_trace() const;
 
   void begin_graph_evaluation();
   void end_graph_evaluation();
@@ -53,6 +55,9 @@ class DepsgraphDebug {
    * This is NOT an indication that depsgraph is at its evaluated state. */
   bool is_ever_evaluated;
 
+  /* Operations evaluated by the recent graph evaluations, recorded when do_trace() is true. */
+  DepsgraphTrace trace;
+
  protected:
   /* Maximum number of counters used to calculate frame rate of depsgraph update. */
   static const constexpr int MAX_FPS_COUNTERS = 64;
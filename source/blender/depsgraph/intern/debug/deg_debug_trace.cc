@@ -0,0 +1,149 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#include "intern/debug/deg_debug_trace.h"
+
+#include "BLI_string_utf8.h"
+#include "BLI_utildefines.h"
+
+#include "atomic_ops.h"
+
+#include "intern/node/deg_node.h"
+#include "intern/node/deg_node_component.h"
+#include "intern/node/deg_node_id.h"
+#include "intern/node/deg_node_operation.h"
+
+#define NL "\r\n"
+
+namespace blender {
+namespace deg {
+
+namespace {
+
+/* Small sequential index of the calling thread, used as thread identifier in the trace. */
+int trace_thread_index()
+{
+  static int num_threads = 0;
+  static thread_local int thread_index = -1;
+  if (thread_index == -1) {
+    thread_index = atomic_fetch_and_add_int32(&num_threads, 1);
+  }
+  return thread_index;
+}
+
+/* Write string as JSON string literal, ID and bone names might contain any character. */
+void write_json_string(FILE *stream, const char *str)
+{
+  fputc('"', stream);
+  for (const char *c = str; *c != '\0'; c++) {
+    if (*c == '"' || *c == '\\') {
+      fputc('\\', stream);
+      fputc(*c, stream);
+    }
+    else if ((unsigned char)*c < 0x20) {
+      fprintf(stream, "\\u%04x", (unsigned char)*c);
+    }
+    else {
+      fputc(*c, stream);
+    }
+  }
+  fputc('"', stream);
+}
+
+}  // namespace
+
+DepsgraphTrace::DepsgraphTrace() : num_events_(0)
+{
+}
+
+void DepsgraphTrace::ensure_allocated()
+{
+  if (events_.size() == 0) {
+    events_ = Array<TraceEvent, 0>(MAX_EVENTS, NoInitialization());
+  }
+}
+
+void DepsgraphTrace::add_event(const OperationNode *operation_node,
+                               const double start_time,
+                               const double end_time)
+{
+  BLI_assert(events_.size() == MAX_EVENTS);
+  const uint64_t index = atomic_fetch_and_add_uint64(&num_events_, 1);
+  TraceEvent &event = events_[index % MAX_EVENTS];
+  const ComponentNode *component_node = operation_node->owner;
+  const IDNode *id_node = component_node->owner;
+  /* Skip the ID code, the component type tells what the data-block is. */
+  STRNCPY_UTF8(event.id_name, id_node->id_orig->name + 2);
+  STRNCPY_UTF8(event.component_name, component_node->name.c_str());
+  STRNCPY_UTF8(event.operation_name, operation_node->name.c_str());
+  event.component_type = nodeTypeAsString(component_node->type);
+  event.opcode = operationCodeAsString(operation_node->opcode);
+  event.name_tag = operation_node->name_tag;
+  event.thread_index = trace_thread_index();
+  event.start_time = start_time;
+  event.end_time = end_time;
+}
+
+void DepsgraphTrace::clear()
+{
+  num_events_ = 0;
+}
+
+void DepsgraphTrace::write_chrome_json(FILE *stream, const char *graph_name) const
+{
+  const int num_stored = (num_events_ > MAX_EVENTS) ? MAX_EVENTS : (int)num_events_;
+  const int first = (num_events_ > MAX_EVENTS) ? (int)(num_events_ % MAX_EVENTS) : 0;
+  double base_time = 0.0;
+  for (int i = 0; i < num_stored; i++) {
+    const TraceEvent &event = events_[(first + i) % MAX_EVENTS];
+    if (i == 0 || event.start_time < base_time) {
+      base_time = event.start_time;
+    }
+  }
+
+  fprintf(stream, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [" NL);
+  fprintf(stream, "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 0, \"args\": {\"name\": ");
+  write_json_string(stream, graph_name);
+  fprintf(stream, "}}");
+  for (int i = 0; i < num_stored; i++) {
+    const TraceEvent &event = events_[(first + i) % MAX_EVENTS];
+    fprintf(stream, "," NL "{\"name\": ");
+    write_json_string(stream, event.id_name);
+    fprintf(stream, ", \"cat\": \"%s\", \"ph\": \"X\"", event.component_type);
+    /* Timestamps are in microseconds. */
+    fprintf(stream,
+            ", \"ts\": %.3f, \"dur\": %.3f, \"pid\": 0, \"tid\": %d",
+            (event.start_time - base_time) * 1e6,
+            (event.end_time - event.start_time) * 1e6,
+            event.thread_index);
+    fprintf(stream, ", \"args\": {\"component\": ");
+    write_json_string(stream, event.component_name);
+    fprintf(stream, ", \"operation\": \"%s\", \"name\": ", event.opcode);
+    write_json_string(stream, event.operation_name);
+    fprintf(stream, ", \"name_tag\": %d}}", event.name_tag);
+  }
+  fprintf(stream, NL "]}" NL);
+}
+
+}  // namespace deg
+}  // namespace blender
@@ -0,0 +1,79 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#pragma once
+
+#include <cstdio>
+
+#include "BLI_array.hh"
+
+#include "DNA_ID.h"
+
+namespace blender {
+namespace deg {
+
+struct OperationNode;
+
+/* Single evaluated operation, stored by value so the trace outlives graph rebuilds. */
+struct TraceEvent {
+  char id_name[MAX_ID_NAME];
+  char component_name[64];
+  char operation_name[64];
+  /* Static strings from nodeTypeAsString() and operationCodeAsString(). */
+  const char *component_type;
+  const char *opcode;
+  int name_tag;
+  int thread_index;
+  double start_time;
+  double end_time;
+};
+
+/* Ring buffer of the most recently evaluated operations, filled in from evaluation threads
+ * when G_DEBUG_DEPSGRAPH_TRACE is enabled. */
+class DepsgraphTrace {
+ public:
+  /* Maximum number of stored events, older events are overwritten. */
+  static const constexpr int MAX_EVENTS = 32768;
+
+  DepsgraphTrace();
+
+  /* Allocate storage, is to be called before evaluation threads start adding events. */
+  void ensure_allocated();
+
+  /* Safe to be called from multiple threads at the same time. */
+  void add_event(const OperationNode *operation_node, double start_time, double end_time);
+
+  void clear();
+
+  /* Write stored events in the Chrome trace event format, which can be loaded into
+   * chrome://tracing or similar timeline viewers. */
+  void write_chrome_json(FILE *stream, const char *graph_name) const;
+
+ protected:
+  Array<TraceEvent, 0> events_;
+  /* Total number of recorded events, including overwritten ones. */
+  uint64_t num_events_;
+};
+
+}  // namespace deg
+}  // namespace blender
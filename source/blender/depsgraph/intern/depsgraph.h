@@ -110,6 +110,10 @@ struct Depsgraph {
   /* Indicates whether relations needs to be updated. */
   bool need_update;
 
+  /* IDs which relations are to be updated without rebuilding the whole graph.
+   * Not used when the whole graph needs to be updated anyway. */
+  Set<ID *> need_update_relations_ids;
+
   /* Indicates which ID types were updated. */
   char id_type_updated[MAX_LIBARRAY];
 
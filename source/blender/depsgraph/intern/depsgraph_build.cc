@@ -268,8 +268,15 @@ void DEG_graph_relations_update(Depsgraph *graph, Main *bmain, Scene *scene, Vie
 {
   deg::Depsgraph *deg_graph = (deg::Depsgraph *)graph;
   if (!deg_graph->need_update) {
-    /* Graph is up to date, nothing to do. */
-    return;
+    if (deg_graph->need_update_relations_ids.is_empty()) {
+      /* Graph is up to date, nothing to do. */
+      return;
+    }
+    /* Only rebuild nodes and relations of the tagged IDs if possible. */
+    deg::ViewLayerIncrementalBuilderPipeline builder(graph, bmain, scene, view_layer);
+    if (builder.build_incremental()) {
+      return;
+    }
   }
   DEG_graph_build_from_view_layer(graph, bmain, scene, view_layer);
 }
@@ -282,3 +289,16 @@ void DEG_relations_tag_update(Main *bmain)
     DEG_graph_tag_relations_update(reinterpret_cast<Depsgraph *>(depsgraph));
   }
 }
+
+/* Tag relations of a single ID for update. */
+void DEG_id_tag_relations_update(Main *bmain, ID *id)
+{
+  DEG_GLOBAL_DEBUG_PRINTF(TAG, "%s: Tagging relations of %s for update.\n", __func__, id->name);
+  for (deg::Depsgraph *depsgraph : deg::get_all_registered_graphs(bmain)) {
+    if (depsgraph->need_update) {
+      /* Whole graph is to be rebuilt anyway. */
+      continue;
+    }
+    depsgraph->need_update_relations_ids.add(id);
+  }
+}
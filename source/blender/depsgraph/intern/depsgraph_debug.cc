@@ -68,6 +68,19 @@ const char *DEG_debug_name_get(struct Depsgraph *depsgraph)
   return deg_graph->debug.name.c_str();
 }
 
+void DEG_debug_trace_chrome_json(const Depsgraph *graph, FILE *stream)
+{
+  const deg::Depsgraph *deg_graph = reinterpret_cast<const deg::Depsgraph *>(graph);
+  const char *name = deg_graph->debug.name.empty() ? "Depsgraph" : deg_graph->debug.name.c_str();
+  deg_graph->debug.trace.write_chrome_json(stream, name);
+}
+
+void DEG_debug_trace_clear(Depsgraph *graph)
+{
+  deg::Depsgraph *deg_graph = reinterpret_cast<deg::Depsgraph *>(graph);
+  deg_graph->debug.trace.clear();
+}
+
 bool DEG_debug_compare(const struct Depsgraph *graph1, const struct Depsgraph *graph2)
 {
   BLI_assert(graph1 != nullptr);
@@ -29,7 +29,9 @@
 
 #include "BLI_compiler_attrs.h"
 #include "BLI_gsqueue.h"
+#include "BLI_heap_simple.h"
 #include "BLI_task.h"
+#include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
 #include "BKE_global.h"
@@ -69,10 +71,7 @@ void schedule_children(DepsgraphEvalState *state,
                        ScheduleFunction *schedule_function,
                        ScheduleFunctionArgs... schedule_function_args);
 
-void schedule_node_to_pool(OperationNode *node, const int UNUSED(thread_id), TaskPool *pool)
-{
-  BLI_task_pool_push(pool, deg_task_run_func, node, false, NULL);
-}
+void schedule_node_to_pool(OperationNode *node, const int thread_id, TaskPool *pool);
 
 /* Denotes which part of dependency graph is being evaluated. */
 enum class EvaluationStage {
@@ -94,34 +93,53 @@ enum class EvaluationStage {
 struct DepsgraphEvalState {
   Depsgraph *graph;
   bool do_stats;
+  bool do_trace;
   EvaluationStage stage;
   bool need_single_thread_pass;
+  /* Operations which are ready to be evaluated, ordered by their critical path cost. Every task
+   * in the pool evaluates the operation with the longest remaining path, so that long chains of
+   * dependent operations start as early as possible. */
+  HeapSimple *ready_heap;
+  SpinLock ready_heap_lock;
 };
 
+void schedule_node_to_pool(OperationNode *node, const int UNUSED(thread_id), TaskPool *pool)
+{
+  DepsgraphEvalState *state = (DepsgraphEvalState *)BLI_task_pool_user_data(pool);
+  BLI_spin_lock(&state->ready_heap_lock);
+  BLI_heapsimple_insert(state->ready_heap, -node->critical_path_cost, node);
+  BLI_spin_unlock(&state->ready_heap_lock);
+  BLI_task_pool_push(pool, deg_task_run_func, NULL, false, NULL);
+}
+
 void evaluate_node(const DepsgraphEvalState *state, OperationNode *operation_node)
 {
   ::Depsgraph *depsgraph = reinterpret_cast<::Depsgraph *>(state->graph);
 
   /* Sanity checks. */
   BLI_assert(!operation_node->is_noop() && "NOOP nodes should not actually be scheduled");
-  /* Perform operation. */
-  if (state->do_stats) {
-    const double start_time = PIL_check_seconds_timer();
-    operation_node->evaluate(depsgraph);
-    operation_node->stats.current_time += PIL_check_seconds_timer() - start_time;
-  }
-  else {
-    operation_node->evaluate(depsgraph);
+  /* Perform operation. Timing is always measured, it is used for scheduling. */
+  const double start_time = PIL_check_seconds_timer();
+  operation_node->evaluate(depsgraph);
+  const double end_time = PIL_check_seconds_timer();
+  operation_node->stats.current_time += end_time - start_time;
+  if (state->do_trace) {
+    state->graph->debug.trace.add_event(operation_node, start_time, end_time);
   }
 }
 
-void deg_task_run_func(TaskPool *pool, void *taskdata)
+void deg_task_run_func(TaskPool *pool, void *UNUSED(taskdata))
 {
   void *userdata_v = BLI_task_pool_user_data(pool);
   DepsgraphEvalState *state = (DepsgraphEvalState *)userdata_v;
 
+  /* Every task corresponds to a single scheduled operation, but not necessarily the one it was
+   * pushed for: pick the ready operation with the longest remaining path. */
+  BLI_spin_lock(&state->ready_heap_lock);
+  OperationNode *operation_node = (OperationNode *)BLI_heapsimple_pop_min(state->ready_heap);
+  BLI_spin_unlock(&state->ready_heap_lock);
+
   /* Evaluate node. */
-  OperationNode *operation_node = reinterpret_cast<OperationNode *>(taskdata);
   evaluate_node(state, operation_node);
 
   /* Schedule children. */
@@ -178,15 +196,12 @@ void calculate_pending_parents(Depsgraph *graph)
   }
 }
 
-void initialize_execution(DepsgraphEvalState *state, Depsgraph *graph)
+void initialize_execution(DepsgraphEvalState *UNUSED(state), Depsgraph *graph)
 {
-  const bool do_stats = state->do_stats;
   calculate_pending_parents(graph);
   /* Clear tags and other things which needs to be clear. */
   for (OperationNode *node : graph->operations) {
-    if (do_stats) {
-      node->stats.reset_current();
-    }
+    node->stats.reset_current();
   }
 }
 
@@ -379,7 +394,13 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   DepsgraphEvalState state;
   state.graph = graph;
   state.do_stats = graph->debug.do_time_debug();
+  state.do_trace = graph->debug.do_trace();
+  if (state.do_trace) {
+    graph->debug.trace.ensure_allocated();
+  }
   state.need_single_thread_pass = false;
+  state.ready_heap = BLI_heapsimple_new();
+  BLI_spin_init(&state.ready_heap_lock);
   /* Prepare all nodes for evaluation. */
   initialize_execution(&state, graph);
 
@@ -409,6 +430,9 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   if (state.do_stats) {
     deg_eval_stats_aggregate(graph);
   }
+  deg_eval_stats_update_costs(graph);
+  BLI_heapsimple_free(state.ready_heap, NULL);
+  BLI_spin_end(&state.ready_heap_lock);
   /* Clear any uncleared tags - just in case. */
   deg_graph_clear_tags(graph);
   graph->is_evaluating = false;
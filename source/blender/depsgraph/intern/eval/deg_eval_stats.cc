@@ -23,9 +23,12 @@
 
 #include "intern/eval/deg_eval_stats.h"
 
+#include "BLI_math_base.h"
 #include "BLI_utildefines.h"
+#include "BLI_vector.hh"
 
 #include "intern/depsgraph.h"
+#include "intern/depsgraph_relation.h"
 
 #include "intern/node/deg_node.h"
 #include "intern/node/deg_node_component.h"
@@ -55,5 +58,82 @@ void deg_eval_stats_aggregate(Depsgraph *graph)
   }
 }
 
+/* Weight of the latest measurement in the smoothed operation cost. */
+#define EVAL_COST_FACTOR 0.25f
+/* Change of an operation cost, relative to the cost of the critical path starting at it,
+ * which makes critical paths to be re-calculated. */
+#define EVAL_COST_CHANGE_THRESHOLD 0.25f
+/* Changes below this many seconds never re-calculate critical paths, so timer noise on tiny
+ * operations doesn't cause re-calculation on every evaluation. */
+#define EVAL_COST_CHANGE_MIN 1e-4f
+/* Cost of operations which were never measured, in seconds. Makes it so graphs without timing
+ * information are prioritized by the number of operations on the longest path. */
+#define EVAL_COST_MIN 1e-6f
+
+void deg_eval_stats_update_costs(Depsgraph *graph)
+{
+  bool need_update = false;
+  for (OperationNode *op_node : graph->operations) {
+    if (!op_node->scheduled || op_node->is_noop()) {
+      continue;
+    }
+    const float time = (float)op_node->stats.current_time;
+    if (op_node->eval_cost == 0.0f) {
+      op_node->eval_cost = max_ff(time, EVAL_COST_MIN);
+      need_update = true;
+      continue;
+    }
+    const float old_cost = op_node->eval_cost;
+    op_node->eval_cost += (time - old_cost) * EVAL_COST_FACTOR;
+    const float change_threshold = max_ff(
+        op_node->critical_path_cost * EVAL_COST_CHANGE_THRESHOLD, EVAL_COST_CHANGE_MIN);
+    if (fabsf(op_node->eval_cost - old_cost) > change_threshold) {
+      need_update = true;
+    }
+  }
+  if (need_update) {
+    deg_eval_critical_paths_update(graph);
+  }
+}
+
+void deg_eval_critical_paths_update(Depsgraph *graph)
+{
+  /* Visit operations in reverse topological order, so all children of an operation are known
+   * by the time it is visited. Count of not yet visited children is stored in custom_flags. */
+  Vector<OperationNode *> stack;
+  for (OperationNode *op_node : graph->operations) {
+    int num_children = 0;
+    for (Relation *rel : op_node->outlinks) {
+      if (rel->to->type == NodeType::OPERATION && (rel->flag & RELATION_FLAG_CYCLIC) == 0) {
+        num_children++;
+      }
+    }
+    op_node->custom_flags = num_children;
+    op_node->critical_path_cost = op_node->is_noop() ? 0.0f :
+                                                       max_ff(op_node->eval_cost, EVAL_COST_MIN);
+    if (num_children == 0) {
+      stack.append(op_node);
+    }
+  }
+  while (!stack.is_empty()) {
+    OperationNode *op_node = stack.pop_last();
+    float max_child_cost = 0.0f;
+    for (Relation *rel : op_node->outlinks) {
+      if (rel->to->type == NodeType::OPERATION && (rel->flag & RELATION_FLAG_CYCLIC) == 0) {
+        max_child_cost = max_ff(max_child_cost, ((OperationNode *)rel->to)->critical_path_cost);
+      }
+    }
+    op_node->critical_path_cost += max_child_cost;
+    for (Relation *rel : op_node->inlinks) {
+      if (rel->from->type == NodeType::OPERATION && (rel->flag & RELATION_FLAG_CYCLIC) == 0) {
+        OperationNode *from = (OperationNode *)rel->from;
+        if (--from->custom_flags == 0) {
+          stack.append(from);
+        }
+      }
+    }
+  }
+}
+
 }  // namespace deg
 }  // namespace blender
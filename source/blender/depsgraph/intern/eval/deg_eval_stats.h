@@ -31,5 +31,13 @@ struct Depsgraph;
 /* Aggregate operation timings to overall component and ID nodes timing. */
 void deg_eval_stats_aggregate(Depsgraph *graph);
 
+/* Update measured evaluation cost of operations evaluated by the last graph evaluation, and
+ * re-calculate critical paths if the costs changed noticeably. */
+void deg_eval_stats_update_costs(Depsgraph *graph);
+
+/* Calculate length of the longest chain of dependent operations starting at every operation,
+ * using measured evaluation costs. */
+void deg_eval_critical_paths_update(Depsgraph *graph);
+
 }  // namespace deg
 }  // namespace blender
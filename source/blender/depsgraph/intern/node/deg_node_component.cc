@@ -180,7 +180,13 @@ OperationNode *ComponentNode::add_operation(const DepsEvalOperationCb &op,
 
     /* register opnode in this component's operation set */
     OperationIDKey key(opcode, name, name_tag);
-    operations_map->add(key, op_node);
+    if (operations_map != nullptr) {
+      operations_map->add(key, op_node);
+    }
+    else {
+      /* Component was finalized by a previous build, happens on incremental builds. */
+      operations.append(op_node);
+    }
 
     /* set backlink */
     op_node->owner = this;
@@ -290,6 +296,10 @@ OperationNode *ComponentNode::get_exit_operation()
 
 void ComponentNode::finalize_build(Depsgraph * /*graph*/)
 {
+  if (operations_map == nullptr) {
+    /* Already finalized by a previous build. */
+    return;
+  }
   operations.reserve(operations_map->size());
   for (OperationNode *op_node : operations_map->values()) {
     operations.append(op_node);
@@ -273,6 +273,13 @@ struct OperationNode : public Node {
   /* (OperationFlag) extra settings affecting evaluation. */
   int flag;
 
+  /* Smoothed evaluation time of this operation in seconds, measured during previous evaluations.
+   * Zero when the operation was never evaluated. */
+  float eval_cost;
+  /* Estimated time needed to evaluate this operation and the longest chain of operations which
+   * depend on it. Used to evaluate operations on the critical path first. */
+  float critical_path_cost;
+
   DEG_DEPSNODE_DECLARE;
 };
 
@@ -2084,7 +2084,13 @@ static int constraint_add_exec(
   }
 
   /* force depsgraph to get recalculated since new relationships added */
-  DEG_relations_tag_update(bmain);
+  if (setTarget) {
+    /* A new target object might have been added to the scene. */
+    DEG_relations_tag_update(bmain);
+  }
+  else {
+    DEG_id_tag_relations_update(bmain, &ob->id);
+  }
 
   if ((ob->type == OB_ARMATURE) && (pchan)) {
     BKE_pose_tag_recalc(bmain, ob->pose); /* sort pose channels */
@@ -97,6 +97,16 @@ int DNA_struct_find_nr_ex(const struct SDNA *sdna, const char *str, unsigned int
 int DNA_struct_find_nr(const struct SDNA *sdna, const char *str);
 void DNA_struct_switch_endian(const struct SDNA *oldsdna, int oldSDNAnr, char *data);
 const char *DNA_struct_get_compareflags(const struct SDNA *sdna, const struct SDNA *newsdna);
+int DNA_struct_reconstruct_size(const struct SDNA *newsdna,
+                                const struct SDNA *oldsdna,
+                                int oldSDNAnr);
+void DNA_struct_reconstruct_into(const struct SDNA *newsdna,
+                                 const struct SDNA *oldsdna,
+                                 const char *compflags,
+                                 int oldSDNAnr,
+                                 int blocks,
+                                 const void *data,
+                                 void *cur);
 void *DNA_struct_reconstruct(const struct SDNA *newsdna,
                              const struct SDNA *oldsdna,
                              const char *compflags,
@@ -109,6 +119,7 @@ int DNA_elem_offset(struct SDNA *sdna, const char *stype, const char *vartype, c
 int DNA_elem_size_nr(const struct SDNA *sdna, short type, short name);
 
 bool DNA_struct_find(const struct SDNA *sdna, const char *stype);
+bool DNA_struct_has_pointers(const struct SDNA *sdna, const char *stype);
 bool DNA_struct_elem_find(const struct SDNA *sdna,
                           const char *stype,
                           const char *vartype,
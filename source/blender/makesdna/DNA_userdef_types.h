@@ -622,8 +622,10 @@ typedef struct UserDef_Experimental {
   char use_new_hair_type;
   char use_cycles_debug;
   char use_sculpt_vertex_colors;
+  char use_undo_skip_unchanged_ids;
+  char use_full_frame_compositor;
   /** `makesdna` does not allow empty structs. */
-  char _pad[3];
+  char _pad[1];
 } UserDef_Experimental;
 
 #define USER_EXPERIMENTAL_TEST(userdef, member) \
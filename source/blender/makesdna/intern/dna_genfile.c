@@ -1390,6 +1390,64 @@ void DNA_struct_switch_endian(const SDNA *oldsdna, int oldSDNAnr, char *data)
   }
 }
 
+/**
+ * \param newsdna: SDNA of current Blender
+ * \param oldsdna: SDNA of Blender that saved file
+ * \param oldSDNAnr: Index of struct info within oldsdna
+ * \return The size of one reconstructed struct, zero when the struct no longer exists.
+ */
+int DNA_struct_reconstruct_size(const SDNA *newsdna, const SDNA *oldsdna, int oldSDNAnr)
+{
+  const short *spo = oldsdna->structs[oldSDNAnr];
+  const int curSDNAnr = DNA_struct_find_nr(newsdna, oldsdna->types[spo[0]]);
+
+  if (curSDNAnr == -1) {
+    return 0;
+  }
+  return newsdna->types_size[newsdna->structs[curSDNAnr][0]];
+}
+
+/**
+ * Reconstruct \a blocks structs into memory allocated by the caller,
+ * see #DNA_struct_reconstruct for the other arguments.
+ *
+ * Only reads from the SDNA, so disjoint ranges of one array can be reconstructed
+ * from multiple threads.
+ *
+ * \param cur: Zero initialized memory of `blocks * DNA_struct_reconstruct_size(...)` bytes.
+ */
+void DNA_struct_reconstruct_into(const SDNA *newsdna,
+                                 const SDNA *oldsdna,
+                                 const char *compflags,
+                                 int oldSDNAnr,
+                                 int blocks,
+                                 const void *data,
+                                 void *cur)
+{
+  int a, curSDNAnr, curlen, oldlen;
+  const short *spo, *spc;
+  char *cpc;
+  const char *cpo;
+
+  /* oldSDNAnr == structnr, we're looking for the corresponding 'cur' number */
+  spo = oldsdna->structs[oldSDNAnr];
+  oldlen = oldsdna->types_size[spo[0]];
+  curSDNAnr = DNA_struct_find_nr(newsdna, oldsdna->types[spo[0]]);
+  if (curSDNAnr == -1) {
+    return;
+  }
+  spc = newsdna->structs[curSDNAnr];
+  curlen = newsdna->types_size[spc[0]];
+
+  cpc = cur;
+  cpo = data;
+  for (a = 0; a < blocks; a++) {
+    reconstruct_struct(newsdna, oldsdna, compflags, oldSDNAnr, cpo, curSDNAnr, cpc);
+    cpc += curlen;
+    cpo += oldlen;
+  }
+}
+
 /**
  * \param newsdna: SDNA of current Blender
  * \param oldsdna: SDNA of Blender that saved file
@@ -1408,35 +1466,15 @@ void *DNA_struct_reconstruct(const SDNA *newsdna,
                              int blocks,
                              const void *data)
 {
-  int a, curSDNAnr, curlen = 0, oldlen;
-  const short *spo, *spc;
-  char *cur, *cpc;
-  const char *cpo;
-  const char *type;
-
-  /* oldSDNAnr == structnr, we're looking for the corresponding 'cur' number */
-  spo = oldsdna->structs[oldSDNAnr];
-  type = oldsdna->types[spo[0]];
-  oldlen = oldsdna->types_size[spo[0]];
-  curSDNAnr = DNA_struct_find_nr(newsdna, type);
+  const int curlen = DNA_struct_reconstruct_size(newsdna, oldsdna, oldSDNAnr);
+  char *cur;
 
-  /* init data and alloc */
-  if (curSDNAnr != -1) {
-    spc = newsdna->structs[curSDNAnr];
-    curlen = newsdna->types_size[spc[0]];
-  }
   if (curlen == 0) {
     return NULL;
   }
 
   cur = MEM_callocN(blocks * curlen, "reconstruct");
-  cpc = cur;
-  cpo = data;
-  for (a = 0; a < blocks; a++) {
-    reconstruct_struct(newsdna, oldsdna, compflags, oldSDNAnr, cpo, curSDNAnr, cpc);
-    cpc += curlen;
-    cpo += oldlen;
-  }
+  DNA_struct_reconstruct_into(newsdna, oldsdna, compflags, oldSDNAnr, blocks, data, cur);
 
   return cur;
 }
@@ -1459,6 +1497,39 @@ bool DNA_struct_find(const SDNA *sdna, const char *stype)
   return DNA_struct_find_nr(sdna, stype) != -1;
 }
 
+static bool struct_has_pointers(const SDNA *sdna, const int SDNAnr)
+{
+  const short *sp = sdna->structs[SDNAnr];
+  const int elems = sp[1];
+
+  sp += 2;
+  for (int a = 0; a < elems; a++, sp += 2) {
+    if (ispointer(sdna->names[sp[1]])) {
+      return true;
+    }
+    /* Nested structs, pointers inside of them are part of this struct too. */
+    const int member_SDNAnr = DNA_struct_find_nr(sdna, sdna->types[sp[0]]);
+    if (member_SDNAnr != -1 && struct_has_pointers(sdna, member_SDNAnr)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Check if the struct has pointer members, including those of structs it contains by value.
+ * Such structs can't be compared by their bytes, pointer values differ between copies.
+ */
+bool DNA_struct_has_pointers(const SDNA *sdna, const char *stype)
+{
+  const int SDNAnr = DNA_struct_find_nr(sdna, stype);
+
+  if (SDNAnr == -1) {
+    return false;
+  }
+  return struct_has_pointers(sdna, SDNAnr);
+}
+
 bool DNA_struct_elem_find(const SDNA *sdna,
                           const char *stype,
                           const char *vartype,
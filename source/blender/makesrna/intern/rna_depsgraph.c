@@ -250,6 +250,21 @@ static void rna_Depsgraph_debug_stats_gnuplot(Depsgraph *depsgraph,
   fclose(f);
 }
 
+static void rna_Depsgraph_debug_trace_export(Depsgraph *depsgraph, const char *filename)
+{
+  FILE *f = fopen(filename, "w");
+  if (f == NULL) {
+    return;
+  }
+  DEG_debug_trace_chrome_json(depsgraph, f);
+  fclose(f);
+}
+
+static void rna_Depsgraph_debug_trace_clear(Depsgraph *depsgraph)
+{
+  DEG_debug_trace_clear(depsgraph);
+}
+
 static void rna_Depsgraph_debug_tag_update(Depsgraph *depsgraph)
 {
   DEG_graph_tag_relations_update(depsgraph);
@@ -654,6 +669,17 @@ static void rna_def_depsgraph(BlenderRNA *brna)
                                   "File name where gnuplot script will save the result");
   RNA_def_parameter_flags(parm, 0, PARM_REQUIRED);
 
+  func = RNA_def_function(srna, "debug_trace_export", "rna_Depsgraph_debug_trace_export");
+  RNA_def_function_ui_description(func,
+                                  "Export evaluation timeline recorded with debug_depsgraph_trace "
+                                  "enabled, in the Chrome trace event format");
+  parm = RNA_def_string_file_path(
+      func, "filename", NULL, FILE_MAX, "File Name", "Output path for the JSON trace file");
+  RNA_def_parameter_flags(parm, 0, PARM_REQUIRED);
+
+  func = RNA_def_function(srna, "debug_trace_clear", "rna_Depsgraph_debug_trace_clear");
+  RNA_def_function_ui_description(func, "Remove all recorded evaluation timeline events");
+
   func = RNA_def_function(srna, "debug_tag_update", "rna_Depsgraph_debug_tag_update");
 
   func = RNA_def_function(srna, "debug_stats", "rna_Depsgraph_debug_stats");
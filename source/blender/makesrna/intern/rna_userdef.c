@@ -6119,6 +6119,21 @@ static void rna_def_userdef_experimental(BlenderRNA *brna)
   prop = RNA_def_property(srna, "use_sculpt_vertex_colors", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, NULL, "use_sculpt_vertex_colors", 1);
   RNA_def_property_ui_text(prop, "Sculpt Vertex Colors", "Use the new Vertex Painting system");
+
+  prop = RNA_def_property(srna, "use_undo_skip_unchanged_ids", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "use_undo_skip_unchanged_ids", 1);
+  RNA_def_property_ui_text(prop,
+                           "Undo Skip Unchanged",
+                           "Re-use the previous undo step's memory for data-blocks which were not "
+                           "tagged for update, instead of storing them again (faster undo pushes "
+                           "in large scenes, changes made without an update may not be undone)");
+
+  prop = RNA_def_property(srna, "use_full_frame_compositor", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "use_full_frame_compositor", 1);
+  RNA_def_property_ui_text(prop,
+                           "Full Frame Compositor",
+                           "Execute compositor nodes one buffer after the other over the whole "
+                           "frame, instead of scheduling tiles on demand");
 }
 
 static void rna_def_userdef_addon_collection(BlenderRNA *brna, PropertyRNA *cprop)
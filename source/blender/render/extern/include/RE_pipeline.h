@@ -147,6 +147,9 @@ typedef struct RenderResult {
   /* for render results in Image, verify validity for sequences */
   int framenr;
 
+  /* changes whenever the pixels may have changed, never reused between render results */
+  unsigned int update_id;
+
   /* for acquire image, to indicate if it there is a combined layer */
   int have_combined;
 
@@ -28,6 +28,8 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "atomic_ops.h"
+
 #include "BLI_ghash.h"
 #include "BLI_hash_md5.h"
 #include "BLI_listbase.h"
@@ -281,6 +283,16 @@ RenderPass *render_layer_add_pass(RenderResult *rr,
   return rpass;
 }
 
+/* Last #RenderResult.update_id handed out, shared by all results so ids are never reused. */
+static uint32_t render_result_update_id_last = 0;
+
+/* Tag pixels of the result as changed, so copies made from it (like cached compositor buffers)
+ * can be detected to be outdated. Called from threads. */
+static void render_result_tag_update(RenderResult *rr)
+{
+  rr->update_id = atomic_add_and_fetch_uint32(&render_result_update_id_last, 1);
+}
+
 /* called by main render as well for parts */
 /* will read info from Render *re to define layers */
 /* called in threads */
@@ -305,6 +317,7 @@ RenderResult *render_result_new(Render *re,
   }
 
   rr = MEM_callocN(sizeof(RenderResult), "new render result");
+  render_result_tag_update(rr);
   rr->rectx = rectx;
   rr->recty = recty;
   rr->renrect.xmin = 0;
@@ -755,6 +768,7 @@ RenderResult *render_result_new_from_exr(
   const char *to_colorspace = IMB_colormanagement_role_colorspace_name_get(
       COLOR_ROLE_SCENE_LINEAR);
 
+  render_result_tag_update(rr);
   rr->rectx = rectx;
   rr->recty = recty;
 
@@ -888,6 +902,8 @@ void render_result_merge(RenderResult *rr, RenderResult *rrpart)
       }
     }
   }
+
+  render_result_tag_update(rr);
 }
 
 /* Called from the UI and render pipeline, to save multilayer and multiview
@@ -1381,6 +1397,8 @@ int render_result_exr_file_read_path(RenderResult *rr,
   IMB_exr_read_channels(exrhandle);
   IMB_exr_close(exrhandle);
 
+  render_result_tag_update(rr);
+
   return 1;
 }
 
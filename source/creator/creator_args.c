@@ -597,6 +597,7 @@ static int arg_handle_print_help(int UNUSED(argc), const char **UNUSED(argv), vo
   BLI_argsPrintArgDoc(ba, "--debug-depsgraph-no-threads");
   BLI_argsPrintArgDoc(ba, "--debug-depsgraph-time");
   BLI_argsPrintArgDoc(ba, "--debug-depsgraph-pretty");
+  BLI_argsPrintArgDoc(ba, "--debug-depsgraph-trace");
   BLI_argsPrintArgDoc(ba, "--debug-gpu");
   BLI_argsPrintArgDoc(ba, "--debug-gpumem");
   BLI_argsPrintArgDoc(ba, "--debug-gpu-shaders");
@@ -978,6 +979,10 @@ static const char arg_handle_debug_mode_generic_set_doc_depsgraph_no_threads[] =
 static const char arg_handle_debug_mode_generic_set_doc_depsgraph_pretty[] =
     "\n\t"
     "Enable colors for dependency graph debug messages.";
+static const char arg_handle_debug_mode_generic_set_doc_depsgraph_trace[] =
+    "\n\t"
+    "Record timeline of dependency graph evaluation, which can be exported from Python using\n\t"
+    "Depsgraph.debug_trace_export().";
 static const char arg_handle_debug_mode_generic_set_doc_gpumem[] =
     "\n\t"
     "Enable GPU memory stats in status bar.";
@@ -2189,6 +2194,12 @@ void main_args_setup(bContext *C, bArgs *ba)
               "--debug-depsgraph-pretty",
               CB_EX(arg_handle_debug_mode_generic_set, depsgraph_pretty),
               (void *)G_DEBUG_DEPSGRAPH_PRETTY);
+  BLI_argsAdd(ba,
+              1,
+              NULL,
+              "--debug-depsgraph-trace",
+              CB_EX(arg_handle_debug_mode_generic_set, depsgraph_trace),
+              (void *)G_DEBUG_DEPSGRAPH_TRACE);
   BLI_argsAdd(ba,
               1,
               NULL,
@@ -0,0 +1,71 @@
+# Apache License, Version 2.0
+
+# ./blender.bin --background -noaudio --factory-startup --python tests/python/bl_depsgraph_relations.py -- --verbose
+import bpy
+import unittest
+
+
+class DepsgraphRelationsTest(unittest.TestCase):
+
+    def setUp(self):
+        bpy.ops.wm.read_homefile(use_factory_startup=True)
+        self.collection = bpy.context.scene.collection
+
+    def add_mesh_object(self, name):
+        mesh = bpy.data.meshes.new(name)
+        ob = bpy.data.objects.new(name, mesh)
+        self.collection.objects.link(ob)
+        return ob
+
+    def evaluated_location_x(self, ob):
+        depsgraph = bpy.context.evaluated_depsgraph_get()
+        return ob.evaluated_get(depsgraph).location.x
+
+    def test_driver_reading_id_property_of_edited_object(self):
+        # A driver of another object reads a custom property of the object whose relations are
+        # updated, the property needs to stay a dependency of the driver.
+        source = self.add_mesh_object("Source")
+        source["prop"] = 1.0
+        driven = self.add_mesh_object("Driven")
+
+        fcurve = driven.driver_add("location", 0)
+        driver = fcurve.driver
+        driver.type = 'AVERAGE'
+        var = driver.variables.new()
+        var.type = 'SINGLE_PROP'
+        var.targets[0].id = source
+        var.targets[0].data_path = '["prop"]'
+
+        self.assertEqual(self.evaluated_location_x(driven), 1.0)
+
+        source.modifiers.new("Subdivision", 'SUBSURF')
+        self.assertEqual(self.evaluated_location_x(driven), 1.0)
+
+        source["prop"] = 2.0
+        source.update_tag()
+        self.assertEqual(self.evaluated_location_x(driven), 2.0)
+
+    def test_edited_object_with_driver_of_own_id_property(self):
+        ob = self.add_mesh_object("Object")
+        ob["prop"] = 1.0
+
+        fcurve = ob.driver_add("location", 0)
+        driver = fcurve.driver
+        driver.type = 'AVERAGE'
+        var = driver.variables.new()
+        var.type = 'SINGLE_PROP'
+        var.targets[0].id = ob
+        var.targets[0].data_path = '["prop"]'
+
+        self.assertEqual(self.evaluated_location_x(ob), 1.0)
+
+        ob.modifiers.new("Subdivision", 'SUBSURF')
+        ob["prop"] = 3.0
+        ob.update_tag()
+        self.assertEqual(self.evaluated_location_x(ob), 3.0)
+
+
+if __name__ == '__main__':
+    import sys
+    sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])
+    unittest.main()